@@ -49,6 +49,12 @@ class CartesianPoseConstraint : virtual public FrameConstraint {
   virtual void Jacobian(Eigen::Ref<const Eigen::MatrixXd> X,
                         Eigen::Ref<Eigen::VectorXd> Jacobian) override;
 
+  virtual void Hessian(Eigen::Ref<const Eigen::MatrixXd> X,
+                       Eigen::Ref<const Eigen::VectorXd> lambda,
+                       Eigen::Ref<Eigen::SparseMatrix<double>> Hessian) override;
+
+  virtual void HessianStructure(Eigen::SparseMatrix<bool>& Hessian) override;
+
  protected:
 
   using RotationVariable = std::conditional_t<Dim == 2, double, Eigen::Vector3d>;
@@ -125,6 +131,25 @@ void CartesianPoseConstraint<Dim>::Jacobian(Eigen::Ref<const Eigen::MatrixXd> X,
   Constraint::Jacobian(X, Jacobian);
 }
 
+template<int Dim>
+void CartesianPoseConstraint<Dim>::Hessian(Eigen::Ref<const Eigen::MatrixXd> X,
+                                           Eigen::Ref<const Eigen::VectorXd> lambda,
+                                           Eigen::Ref<Eigen::SparseMatrix<double>> Hessian) {
+  // d^2/dx_i^2 0.5 * (x_i - x_des_i)^2 = 1
+  const size_t var_t = kDof * t_start_;
+  for (size_t i = 0; i < kDof; i++) {
+    Hessian.coeffRef(var_t + i, var_t + i) += lambda(i);
+  }
+}
+
+template<int Dim>
+void CartesianPoseConstraint<Dim>::HessianStructure(Eigen::SparseMatrix<bool>& Hessian) {
+  const size_t var_t = kDof * t_start_;
+  for (size_t i = 0; i < kDof; i++) {
+    Hessian.coeffRef(var_t + i, var_t + i) = true;
+  }
+}
+
 template<>
 template<typename Derived>
 Eigen::Vector3d CartesianPoseConstraint<3>::ToRotationVariable(const Eigen::RotationBase<Derived,3>& ori) {
@@ -39,6 +39,12 @@ class CollisionConstraint : virtual public FrameConstraint {
   virtual void JacobianIndices(Eigen::Ref<Eigen::ArrayXi> idx_i,
                                Eigen::Ref<Eigen::ArrayXi> idx_j) override;
 
+  virtual void Hessian(Eigen::Ref<const Eigen::MatrixXd> X,
+                       Eigen::Ref<const Eigen::VectorXd> lambda,
+                       Eigen::Ref<Eigen::SparseMatrix<double>> Hessian) override;
+
+  virtual void HessianStructure(Eigen::SparseMatrix<bool>& Hessian) override;
+
   virtual Type constraint_type(size_t idx_constraint) const { return Type::kInequality; }
 
  protected:
@@ -53,6 +59,32 @@ class CollisionConstraint : virtual public FrameConstraint {
                                  double max_dist,
                                  std::optional<ncollide3d::query::Contact>* out_contact = nullptr) const;
 
+  /**
+   * Approximate the contact with an object that has a distance field by the
+   * deepest collision vertex of the ee.
+   */
+  virtual double ComputeSdfDistance(Eigen::Ref<const Eigen::MatrixXd> X, size_t idx_ee,
+                                    const std::string& object_frame, double max_dist,
+                                    std::optional<ncollide3d::query::Contact>* out_contact = nullptr) const;
+
+  // Axis-aligned bounding box in the world frame
+  struct BoundingBox {
+    Eigen::Vector3d mins;
+    Eigen::Vector3d maxs;
+  };
+
+  // Ee/object pair that passed the broadphase
+  struct CandidatePair {
+    double dist;  // Lower bound on the distance between the shapes
+    size_t idx_ee;
+    size_t idx_object;
+  };
+
+  /**
+   * Update the bounding boxes of the ee frames and the moving object frames.
+   */
+  void ComputeBoundingBoxes(Eigen::Ref<const Eigen::MatrixXd> X);
+
   double x_err_ = 0.;
   std::optional<ncollide3d::query::Contact> contact_;
 
@@ -62,6 +94,15 @@ class CollisionConstraint : virtual public FrameConstraint {
   std::vector<std::string> ee_frames_;
   std::vector<std::string> object_frames_;
 
+  // Broadphase state, parallel to ee_frames_ and object_frames_
+  std::vector<BoundingBox> ee_boxes_;
+  std::vector<BoundingBox> object_boxes_;
+  std::vector<bool> is_object_static_;  // Object frames that no variable moves
+  std::vector<CandidatePair> candidates_;
+
+  // Collision vertices of each ee frame, only used for distance fields
+  std::vector<Eigen::Matrix3Xd> ee_points_;
+
   const bool ignore_control_target_;
 
   const World3& world_;
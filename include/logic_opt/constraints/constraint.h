@@ -14,10 +14,12 @@
 
 #include <spatial_dyn/spatial_dyn.h>
 
-#include <fstream>  // std::ofstream
-#include <memory>   // std::unique_ptr
-#include <string>   // std::string
-#include <vector>   // std::vector
+#include <fstream>     // std::ofstream
+#include <functional>  // std::function
+#include <limits>      // std::numeric_limits
+#include <memory>      // std::unique_ptr
+#include <string>      // std::string
+#include <vector>      // std::vector
 
 namespace logic_opt {
 
@@ -30,6 +32,8 @@ class Constraint {
 
   enum class Type { kEquality, kInequality };
 
+  static const size_t kNoIterate = 0;
+
   Constraint(size_t num_constraints, size_t len_jacobian, size_t t_start, size_t num_timesteps,
              const std::string& name_constraint)
       : num_constraints_(num_constraints), len_jacobian_(len_jacobian),
@@ -40,12 +44,21 @@ class Constraint {
   // Optimization methods
   virtual void Evaluate(Eigen::Ref<const Eigen::MatrixXd> Q,
                         Eigen::Ref<Eigen::VectorXd> constraints) {
+    // Keep the values for GaussNewtonHessian() once it is in use
+    if (is_caching_outputs_ && iterate_ != kNoIterate) {
+      if (constraints.data() != cached_constraints_.data()) cached_constraints_ = constraints;
+      iterate_cached_constraints_ = iterate_;
+    }
     if (!log_constraint_.is_open()) return;
     log_constraint_ << constraints.transpose() << std::endl;
   }
 
   virtual void Jacobian(Eigen::Ref<const Eigen::MatrixXd> Q,
                         Eigen::Ref<Eigen::VectorXd> Jacobian) {
+    if (is_caching_outputs_ && iterate_ != kNoIterate) {
+      if (Jacobian.data() != cached_jacobian_.data()) cached_jacobian_ = Jacobian;
+      iterate_cached_jacobian_ = iterate_;
+    }
     if (!log_jacobian_.is_open()) return;
     log_jacobian_ << Jacobian.transpose() << std::endl;
   }
@@ -68,6 +81,20 @@ class Constraint {
   virtual size_t t_start() const { return t_start_; }
   virtual size_t num_timesteps() const { return num_timesteps_; }
 
+  /**
+   * Optimizer iterate that subsequent Evaluate() and Jacobian() calls refer to.
+   *
+   * Intermediate results shared by Evaluate() and Jacobian() are computed once
+   * per iterate by whichever is called first. With kNoIterate, Evaluate()
+   * always recomputes them and Jacobian() assumes that Evaluate() was last
+   * called at the same point.
+   */
+  virtual void set_iterate(size_t iterate) {
+    iterate_ = iterate;
+    if (iterate_ == kNoIterate) iterate_evaluated_ = kNoIterate;
+  }
+  size_t iterate() const { return iterate_; }
+
   // Debug properties
   std::string name;   // Debug name of constraint
 
@@ -85,9 +112,107 @@ class Constraint {
   const size_t t_start_;          // Start timestep
   const size_t num_timesteps_;    // Duration of constraint
 
+  using ErrorFunction = std::function<void(Eigen::Ref<const Eigen::MatrixXd>,
+                                           Eigen::Ref<Eigen::VectorXd>)>;
+
+  /**
+   * Finite-difference Jacobian entries [idx_begin, idx_end) of error(X), a
+   * function that outputs num_constraints() values with the sparsity declared
+   * by JacobianIndices().
+   *
+   * Each variable with requested entries costs one evaluation (two for
+   * central differences). The step size of each variable is h(i), where i is
+   * its row in X. If error_0 is given, forward differences from
+   * error_0 = error(X) are used instead of central differences.
+   *
+   * X is perturbed in a thread-local buffer, so constraints evaluated in
+   * parallel can use the engine concurrently. The buffer is copied from X
+   * once per iterate, and only the perturbed variables are restored after
+   * each call, so X must not change between calls at the same iterate. This
+   * is asserted in debug builds.
+   */
+  void FiniteDifferenceJacobian(Eigen::Ref<const Eigen::MatrixXd> X, const ErrorFunction& error,
+                                Eigen::Ref<const Eigen::VectorXd> h,
+                                Eigen::Ref<Eigen::VectorXd> Jacobian,
+                                size_t idx_begin = 0,
+                                size_t idx_end = std::numeric_limits<size_t>::max(),
+                                const Eigen::VectorXd* error_0 = nullptr);
+
+  /**
+   * Gauss-Newton Hessian for constraints whose rows have the form
+   * c = 0.5 * |r| * r. With the Jacobian |r| * dr/dX, the term
+   * sign(r) * dr/dX^T * dr/dX is added and the curvature |r| * d^2r/dX^2 is
+   * dropped. The values passed to Constraint::Evaluate() and
+   * Constraint::Jacobian() at the current iterate are reused, and the
+   * constraint is only evaluated again if they are missing. Those values are
+   * only kept after the first call, so optimizers that don't use Hessians
+   * pay nothing for the cache.
+   */
+  void GaussNewtonHessian(Eigen::Ref<const Eigen::MatrixXd> X,
+                          Eigen::Ref<const Eigen::VectorXd> lambda,
+                          Eigen::Ref<Eigen::SparseMatrix<double>> Hessian);
+
+  /**
+   * Lower triangle of the outer products of each Jacobian row, the structure
+   * filled by GaussNewtonHessian().
+   */
+  void GaussNewtonHessianStructure(Eigen::SparseMatrix<bool>& Hessian);
+
+  /**
+   * Returns true if Evaluate() needs to recompute its intermediate results,
+   * and marks them as computed at the current iterate.
+   */
+  bool UpdateEvaluate() {
+    if (iterate_ != kNoIterate && iterate_evaluated_ == iterate_) return false;
+    iterate_evaluated_ = iterate_;
+    return true;
+  }
+
+  /**
+   * Returns true if Jacobian() needs to recompute the intermediate results of
+   * Evaluate() because it has not been called at the current iterate.
+   */
+  bool UpdateJacobian() {
+    if (iterate_ == kNoIterate || iterate_evaluated_ == iterate_) return false;
+    iterate_evaluated_ = iterate_;
+    return true;
+  }
+
   std::ofstream log_constraint_;  // Debug log (written to by Evaluate())
   std::ofstream log_jacobian_;  // Debug log (written to by Evaluate())
 
+  size_t iterate_ = kNoIterate;            // Current optimizer iterate
+  size_t iterate_evaluated_ = kNoIterate;  // Iterate of the intermediate results
+
+  // Last outputs at an iterate, for GaussNewtonHessian()
+  bool is_caching_outputs_ = false;
+  Eigen::VectorXd cached_constraints_;
+  Eigen::VectorXd cached_jacobian_;
+  size_t iterate_cached_constraints_ = kNoIterate;
+  size_t iterate_cached_jacobian_ = kNoIterate;
+
+ private:
+
+  // Variable perturbed by FiniteDifferenceJacobian()
+  struct Column {
+    int var;
+    std::vector<size_t> idx_entries;  // Sorted Jacobian entries of the variable
+  };
+
+  /**
+   * Group the Jacobian entries by variable.
+   */
+  void ComputeColumns();
+
+  /**
+   * Cache the sparsity pattern of the Jacobian.
+   */
+  void ComputeSparsity();
+
+  Eigen::ArrayXi idx_i_;  // Sparsity pattern from JacobianIndices()
+  Eigen::ArrayXi idx_j_;
+  std::vector<Column> fd_columns_;
+
 };
 
 class FrameConstraint : public Constraint {
@@ -48,6 +48,8 @@ class MultiConstraint : public Constraint {
   // Constraint properties
   virtual Type constraint_type(size_t idx_constraint) const override;
 
+  virtual void set_iterate(size_t iterate) override;
+
   virtual void OpenConstraintLog(const std::string& filepath) override;
   virtual void OpenJacobianLog(const std::string& filepath) override;
 
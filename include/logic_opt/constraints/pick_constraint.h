@@ -42,6 +42,11 @@ class PickConstraint : virtual public FrameConstraint {
 
  protected:
 
+  /**
+   * Compute x_err_, x_ee_ and dx_err_ at X.
+   */
+  void ComputeError(Eigen::Ref<const Eigen::MatrixXd> X);
+
   double x_err_ = 0.;
 
   Eigen::Vector3d x_ee_ = Eigen::Vector3d::Zero();
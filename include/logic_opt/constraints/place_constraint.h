@@ -48,6 +48,12 @@ class PlaceConstraint : public MultiConstraint {
     virtual void JacobianIndices(Eigen::Ref<Eigen::ArrayXi> idx_i,
                                  Eigen::Ref<Eigen::ArrayXi> idx_j) override;
 
+    virtual void Hessian(Eigen::Ref<const Eigen::MatrixXd> X,
+                         Eigen::Ref<const Eigen::VectorXd> lambda,
+                         Eigen::Ref<Eigen::SparseMatrix<double>> Hessian) override;
+
+    virtual void HessianStructure(Eigen::SparseMatrix<bool>& Hessian) override;
+
   };
 
   class SupportAreaConstraint : virtual public FrameConstraint {
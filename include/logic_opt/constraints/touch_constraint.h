@@ -38,6 +38,12 @@ class TouchConstraint : virtual public FrameConstraint {
   virtual void JacobianIndices(Eigen::Ref<Eigen::ArrayXi> idx_i,
                                Eigen::Ref<Eigen::ArrayXi> idx_j) override;
 
+  virtual void Hessian(Eigen::Ref<const Eigen::MatrixXd> X,
+                       Eigen::Ref<const Eigen::VectorXd> lambda,
+                       Eigen::Ref<Eigen::SparseMatrix<double>> Hessian) override;
+
+  virtual void HessianStructure(Eigen::SparseMatrix<bool>& Hessian) override;
+
  protected:
 
   std::optional<ncollide3d::query::Contact> ComputeError(Eigen::Ref<const Eigen::MatrixXd> X) const;
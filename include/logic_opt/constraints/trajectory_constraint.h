@@ -52,8 +52,18 @@ class TrajectoryConstraint : virtual public FrameConstraint {
                               std::optional<ncollide3d::query::Contact>* out_contact = nullptr,
                               std::string* out_object_closest = nullptr);
 
+  /**
+   * Compute the convex hull swept by the ee between t and t+1.
+   *
+   * If is_perturbation is true, the hull is built only from the points that
+   * were hull vertices at the last unperturbed call. This is meant for finite
+   * difference perturbations. The full hull is used instead whenever the
+   * perturbation moves the points far enough that another point could leave
+   * the hull of the old vertices.
+   */
   virtual std::unique_ptr<ncollide3d::shape::Shape>
-  ComputeConvexHull(Eigen::Ref<const Eigen::MatrixXd> X, const std::string& ee_frame);
+  ComputeConvexHull(Eigen::Ref<const Eigen::MatrixXd> X, const std::string& ee_frame,
+                    bool is_perturbation = false);
 
   virtual double ComputeDistance(Eigen::Ref<const Eigen::MatrixXd> X,
                                  const std::string& ee_frame,
@@ -75,8 +85,16 @@ class TrajectoryConstraint : virtual public FrameConstraint {
 
   std::string object_closest_;
 
+  // Hull vertices of each ee shape component at t followed by their poses at t+1
   std::vector<std::vector<std::array<double, 3>>> augmented_ee_points_;
 
+  // Swept hull of each ee shape component at the last unperturbed call:
+  // indices into augmented_ee_points_ of the hull vertices, distance of the
+  // shallowest other point from the hull boundary, and the points at t+1
+  std::vector<std::vector<size_t>> idx_hull_vertices_;
+  std::vector<double> min_depths_dropped_;
+  std::vector<std::vector<std::array<double, 3>>> ee_points_next_iterate_;
+
   const World3& world_;
 
 };
@@ -0,0 +1,77 @@
+/**
+ * convex_decomposition.h
+ *
+ * Copyright 2026. All Rights Reserved.
+ *
+ * Created: October 17, 2026
+ * Authors: Toki Migimatsu
+ */
+
+#ifndef LOGIC_OPT_CONVEX_DECOMPOSITION_H_
+#define LOGIC_OPT_CONVEX_DECOMPOSITION_H_
+
+#include <array>   // std::array
+#include <memory>  // std::unique_ptr
+#include <string>  // std::string
+#include <vector>  // std::vector
+
+#include <ncollide_cpp/ncollide.h>
+
+namespace logic_opt {
+
+/**
+ * Approximate convex decomposition of a triangle mesh.
+ *
+ * The triangles are split recursively at the median centroid along the
+ * longest axis of their bounding box, always splitting the part with the
+ * largest concavity first. The concavity of a part is the maximum distance
+ * from its vertices to the surface of its convex hull. Splitting stops when
+ * every part is within max_concavity or the decomposition has max_parts parts.
+ */
+class ConvexDecomposition {
+
+ public:
+
+  static constexpr double kDefaultMaxConcavity = 0.005;
+  static constexpr size_t kDefaultMaxParts = 16;
+
+  using Point = std::array<double, 3>;
+  using Triangle = std::array<Point, 3>;
+
+  ConvexDecomposition() {}
+
+  ConvexDecomposition(const std::vector<Triangle>& triangles,
+                      double max_concavity = kDefaultMaxConcavity,
+                      size_t max_parts = kDefaultMaxParts);
+
+  /**
+   * Load the decomposition of the mesh from the cache file next to it, or
+   * compute and save it if the cache is missing or stale. Decompositions are
+   * also kept in memory, keyed by path and modification time, so repeated
+   * calls don't re-read the mesh. Only STL meshes are supported. Returns
+   * nullptr for other formats.
+   */
+  static std::unique_ptr<ConvexDecomposition>
+  LoadOrCompute(const std::string& filename_mesh, double max_concavity = kDefaultMaxConcavity,
+                size_t max_parts = kDefaultMaxParts);
+
+  /**
+   * Hull vertices of each convex part.
+   */
+  const std::vector<std::vector<Point>>& hulls() const { return hulls_; }
+
+  /**
+   * Create a compound of convex hulls, or a single convex hull if the mesh
+   * didn't need to be split.
+   */
+  std::unique_ptr<ncollide3d::shape::Shape> MakeShape() const;
+
+ private:
+
+  std::vector<std::vector<Point>> hulls_;
+
+};
+
+}  // namespace logic_opt
+
+#endif  // LOGIC_OPT_CONVEX_DECOMPOSITION_H_
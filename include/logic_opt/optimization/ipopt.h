@@ -37,6 +37,7 @@ class Ipopt : public Optimizer {
     size_t acceptable_iter = 10;
     size_t print_level = 5;
     std::string logdir;
+    size_t num_threads = 1;  // Threads for constraint evaluation (0 uses all cores)
   };
 
   Ipopt() {}
@@ -50,6 +51,9 @@ class Ipopt : public Optimizer {
 
   static void Terminate();
 
+  const Options& options() const { return options_; }
+  Options& options() { return options_; }
+
   const std::string& status() const { return status_; }
 
  private:
@@ -74,6 +74,11 @@ class MinL2NormObjective : virtual public Objective {
 
   virtual void Gradient(Eigen::Ref<const Eigen::MatrixXd> X, Eigen::Ref<Eigen::MatrixXd> Gradient) override;
 
+  virtual void Hessian(Eigen::Ref<const Eigen::MatrixXd> X, double sigma,
+                       Eigen::Ref<Eigen::SparseMatrix<double>> Hessian) override;
+
+  virtual void HessianStructure(Eigen::SparseMatrix<bool>& Hessian, size_t T) override;
+
  private:
 
   const size_t row_start_;
@@ -118,6 +123,11 @@ class LinearVelocityObjective : virtual public Objective {
 
   virtual void Gradient(Eigen::Ref<const Eigen::MatrixXd> X, Eigen::Ref<Eigen::MatrixXd> Gradient) override;
 
+  virtual void Hessian(Eigen::Ref<const Eigen::MatrixXd> X, double sigma,
+                       Eigen::Ref<Eigen::SparseMatrix<double>> Hessian) override;
+
+  virtual void HessianStructure(Eigen::SparseMatrix<bool>& Hessian, size_t T) override;
+
  protected:
 
   const World<Dim>& world_;
@@ -141,6 +151,11 @@ class AngularVelocityObjective : virtual public Objective {
 
   virtual void Gradient(Eigen::Ref<const Eigen::MatrixXd> X, Eigen::Ref<Eigen::MatrixXd> Gradient) override;
 
+  virtual void Hessian(Eigen::Ref<const Eigen::MatrixXd> X, double sigma,
+                       Eigen::Ref<Eigen::SparseMatrix<double>> Hessian) override;
+
+  virtual void HessianStructure(Eigen::SparseMatrix<bool>& Hessian, size_t T) override;
+
  protected:
 
   const World3& world_;
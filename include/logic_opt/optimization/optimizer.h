@@ -10,6 +10,7 @@
 #ifndef LOGIC_OPT_OPTIMIZER_H_
 #define LOGIC_OPT_OPTIMIZER_H_
 
+#include <atomic>      // std::atomic
 #include <functional>  // std::function
 #include <string>      // std::string
 
@@ -27,6 +28,9 @@ class Optimizer {
 
   struct OptimizationData {
     virtual ~OptimizationData() = default;
+
+    // Stops the optimization early when set from another thread
+    const std::atomic<bool>* is_cancelled = nullptr;
   };
 
   virtual ~Optimizer() = default;
@@ -12,49 +12,78 @@
 
 #include <cstddef>   // ptrdiff_t
 #include <iterator>  // std::input_iterator_tag
+#include <limits>    // std::numeric_limits
 #include <queue>     // std::priority_queue
+#include <utility>   // std::move
 #include <vector>    // std::vector
 
+#include "logic_opt/planning/closed_set.h"
+#include "logic_opt/planning/search_tree.h"
+
 namespace logic_opt {
 
+/**
+ * Queue entry for a node that has not been expanded yet. The path to the node
+ * is stored in the search tree under idx_parent.
+ */
 template<typename NodeT>
 struct SearchNode {
 
-  SearchNode(const NodeT& node, const std::vector<NodeT>& ancestors)
-      : node(node), ancestors(ancestors) {}
+  SearchNode(const NodeT& node, size_t idx_parent, size_t depth, size_t h, size_t idx_insert)
+      : node(node), idx_parent(idx_parent), depth(depth), h(h), idx_insert(idx_insert) {}
 
-  SearchNode(NodeT&& node, std::vector<NodeT>&& ancestors)
-      : node(std::move(node)), ancestors(std::move(ancestors)) {}
+  size_t f() const { return depth + h; }
 
   NodeT node;
-  std::vector<NodeT> ancestors;
+  size_t idx_parent;
+  size_t depth;
+  size_t h;                   // Heuristic value, or the parent's if not evaluated yet
+  bool is_evaluated = false;
+  size_t idx_insert;          // Insertion order for tie-breaking
 
 };
 
-template<typename NodeT, typename Compare>
+/**
+ * Best-first search on f = depth + h.
+ *
+ * HeuristicT is called as heuristic(node) and returns the estimated number of
+ * actions to the goal, or std::numeric_limits<size_t>::max() for dead ends.
+ * Evaluation is lazy: children are queued with their parent's value and are
+ * only evaluated when popped, after which they are requeued if their f value
+ * increased. Ties are broken by lower h, then by insertion order.
+ */
+template<typename NodeT, typename HeuristicT>
 class AStar {
 
  public:
 
   class iterator;
 
-  AStar(const Compare& compare, const NodeT& root, size_t max_depth)
-      : kMaxDepth(max_depth), compare_(compare), root_(root) {}
+  static constexpr size_t kDeadEnd = std::numeric_limits<size_t>::max();
+
+  AStar(const HeuristicT& heuristic, const NodeT& root, size_t max_depth,
+        DuplicateDetection duplicate_detection = DuplicateDetection::kNone)
+      : kMaxDepth(max_depth), kDuplicateDetection(duplicate_detection),
+        heuristic_(heuristic), root_(root) {}
 
-  iterator begin() { iterator it(compare_, root_, kMaxDepth); return ++it; }
-  iterator end() { return iterator(compare_); }
+  iterator begin() { iterator it(heuristic_, root_, kMaxDepth, kDuplicateDetection); return ++it; }
+  iterator end() { return iterator(); }
 
  private:
 
   const size_t kMaxDepth;
+  const DuplicateDetection kDuplicateDetection;
 
-  const Compare& compare_;
+  const HeuristicT& heuristic_;
   const NodeT& root_;
 
 };
 
-template<typename NodeT, typename Compare>
-class AStar<NodeT, Compare>::iterator {
+template<typename NodeT, typename HeuristicT>
+constexpr size_t AStar<NodeT, HeuristicT>::kDeadEnd;
+
+template<typename NodeT, typename HeuristicT>
+class AStar<NodeT, HeuristicT>::iterator {
 
  public:
 
@@ -64,45 +93,79 @@ class AStar<NodeT, Compare>::iterator {
   using pointer = const value_type*;
   using reference = const value_type&;
 
-  iterator(const Compare& compare) : queue_(compare) {}
-  iterator(const Compare& compare, const NodeT& root, size_t max_depth)
-      : queue_(compare), kMaxDepth(max_depth) { queue_.emplace(root, std::vector<NodeT>()); }
+  iterator() {}
+  iterator(const HeuristicT& heuristic, const NodeT& root, size_t max_depth,
+           DuplicateDetection duplicate_detection)
+      : kMaxDepth(max_depth), heuristic_(&heuristic), closed_set_(duplicate_detection) {
+    queue_.emplace(root, SearchTree<NodeT>::kNoParent, 0, 0, num_inserted_++);
+    closed_set_.Insert(root, 0);
+  }
 
   iterator& operator++();
-  bool operator==(const iterator& other) const { return queue_.empty() && other.queue_.empty(); }
+  bool operator==(const iterator& other) const {
+    return queue_.empty() && ancestors_.empty() && other.queue_.empty() && other.ancestors_.empty();
+  }
   bool operator!=(const iterator& other) const { return !(*this == other); }
   reference operator*() const { return ancestors_; }
 
  private:
 
+  struct Compare {
+    bool operator()(const SearchNode<NodeT>& left, const SearchNode<NodeT>& right) const {
+      if (left.f() != right.f()) return left.f() > right.f();
+      if (left.h != right.h) return left.h > right.h;
+      return left.idx_insert > right.idx_insert;
+    }
+  };
+
   const size_t kMaxDepth = 0;
+  const HeuristicT* heuristic_ = nullptr;
 
+  SearchTree<NodeT> tree_;
   std::priority_queue<SearchNode<NodeT>, std::vector<SearchNode<NodeT>>, Compare> queue_;
+  size_t num_inserted_ = 0;
   std::vector<NodeT> ancestors_;
 
+  ClosedSet<NodeT> closed_set_;
+
 };
 
-template<typename NodeT, typename Compare>
-typename AStar<NodeT, Compare>::iterator& AStar<NodeT, Compare>::iterator::operator++() {
+template<typename NodeT, typename HeuristicT>
+typename AStar<NodeT, HeuristicT>::iterator& AStar<NodeT, HeuristicT>::iterator::operator++() {
+  // An empty path marks the end, so the last goal is still returned after the frontier empties
+  ancestors_.clear();
   while (!queue_.empty()) {
     SearchNode<NodeT> top = queue_.top();
-
-    // Take ancestors list and append current node
-    ancestors_.swap(top.ancestors);
-    ancestors_.push_back(std::move(top.node));
     queue_.pop();
 
-    // Return if node evaluates to true
-    const NodeT& node = ancestors_.back();
-    std::cout << node << std::endl;
-    if (node) break;
+    // Return path if node evaluates to true
+    if (top.node) {
+      ancestors_ = tree_.Path(tree_.Add(std::move(top.node), top.idx_parent));
+      break;
+    }
+
+    // Evaluate heuristic and requeue if the node is no longer the best
+    if (!top.is_evaluated) {
+      const size_t f = top.f();
+      top.h = (*heuristic_)(top.node);
+      if (top.h == kDeadEnd) continue;
+      top.is_evaluated = true;
+      if (top.f() > f) {
+        queue_.push(std::move(top));
+        continue;
+      }
+    }
 
     // Skip children if max depth has been reached
-    if (ancestors_.size() > kMaxDepth) continue;
+    if (top.depth >= kMaxDepth) continue;
 
     // Add node's children to queue
+    const size_t idx_node = tree_.Add(std::move(top.node), top.idx_parent);
+    const NodeT& node = tree_.node(idx_node);
     for (const NodeT& child : node) {
-      queue_.emplace(child, ancestors_);
+      // Skip children whose states have already been visited
+      if (!closed_set_.Insert(child, top.depth + 1)) continue;
+      queue_.emplace(child, idx_node, top.depth + 1, top.h, num_inserted_++);
     }
   }
   return *this;
@@ -0,0 +1,149 @@
+/**
+ * atom_index.h
+ *
+ * Copyright 2026. All Rights Reserved.
+ *
+ * Created: October 17, 2026
+ * Authors: Toki Migimatsu
+ */
+
+#ifndef LOGIC_OPT_PLANNING_ATOM_INDEX_H_
+#define LOGIC_OPT_PLANNING_ATOM_INDEX_H_
+
+#include <limits>         // std::numeric_limits
+#include <map>            // std::map
+#include <memory>         // std::shared_ptr
+#include <set>            // std::set
+#include <string>         // std::string
+#include <unordered_map>  // std::unordered_map
+#include <vector>         // std::vector
+
+#include "ptree.h"
+
+#include "logic_opt/planning/objects.h"
+#include "logic_opt/planning/proposition.h"
+#include "logic_opt/planning/state.h"
+
+namespace logic_opt {
+
+/**
+ * Index of all type-correct grounded atoms of a domain/problem.
+ *
+ * Atoms of each predicate occupy a contiguous block of ids, and the id of an
+ * atom within its block is the mixed-radix number formed by the positions of
+ * its arguments in the argument types' object lists. Equality is not indexed;
+ * it is evaluated directly on the symbols.
+ */
+class AtomIndex {
+
+ public:
+
+  static constexpr size_t kNotFound = std::numeric_limits<size_t>::max();
+
+  AtomIndex(const VAL::domain* domain, const std::shared_ptr<const ObjectTypeMap>& objects);
+
+  // Properties
+  size_t size() const { return atoms_.size(); }
+
+  const std::shared_ptr<const ObjectTypeMap>& objects() const { return objects_; }
+
+  const Proposition& atom(size_t idx_atom) const { return atoms_[idx_atom]; }
+
+  /**
+   * Index of the predicate with the given name, or kNotFound.
+   */
+  size_t PredicateIndex(const std::string& name_predicate) const;
+
+  /**
+   * Id of the atom with the given predicate and arguments, or kNotFound if
+   * the arguments are not type-correct.
+   *
+   * Argument i of the predicate is taken from args[idx_args[i]].
+   */
+  size_t AtomId(size_t idx_predicate,
+                const std::vector<const VAL::parameter_symbol*>& args,
+                const std::vector<size_t>& idx_args) const;
+
+  size_t AtomId(size_t idx_predicate,
+                const std::vector<const VAL::parameter_symbol*>& args) const;
+
+  size_t AtomId(const Proposition& P) const;
+
+  /**
+   * Same as above, with argument i taken from object_ids[idx_args[i]]. The
+   * object ids must be valid.
+   */
+  size_t AtomId(size_t idx_predicate, const size_t* object_ids, const size_t* idx_args) const;
+
+  /**
+   * Dense id of the object, or kNotFound.
+   */
+  size_t ObjectId(const VAL::parameter_symbol* object) const;
+
+  /**
+   * Create an empty state with one bit per indexed atom.
+   */
+  State CreateState() const { return State(atoms_.size()); }
+
+  /**
+   * Convert a set of propositions into a state. Equality propositions are
+   * skipped, and propositions that are not in the index throw.
+   */
+  State CreateState(const std::set<Proposition>& propositions) const;
+
+  std::set<Proposition> CreatePropositions(const State& state) const;
+
+ private:
+
+  struct Predicate {
+    std::string name;
+    size_t offset;                                 // Id of the first atom
+    std::vector<size_t> strides;                   // Place value of each argument
+    std::vector<std::vector<size_t>> idx_objects;  // Object id to arg position
+  };
+
+  std::shared_ptr<const ObjectTypeMap> objects_;
+
+  std::unordered_map<const VAL::parameter_symbol*, size_t> idx_objects_;
+  std::map<std::string, size_t> idx_predicates_;
+  std::vector<Predicate> predicates_;
+
+  std::vector<Proposition> atoms_;
+
+};
+
+inline size_t AtomIndex::ObjectId(const VAL::parameter_symbol* object) const {
+  auto it = idx_objects_.find(object);
+  return it == idx_objects_.end() ? kNotFound : it->second;
+}
+
+inline size_t AtomIndex::AtomId(size_t idx_predicate,
+                                const std::vector<const VAL::parameter_symbol*>& args,
+                                const std::vector<size_t>& idx_args) const {
+  const Predicate& pred = predicates_[idx_predicate];
+  size_t idx_atom = pred.offset;
+  for (size_t i = 0; i < idx_args.size(); i++) {
+    const size_t idx_object = ObjectId(args[idx_args[i]]);
+    if (idx_object == kNotFound) return kNotFound;
+    const size_t idx_arg = pred.idx_objects[i][idx_object];
+    if (idx_arg == kNotFound) return kNotFound;
+    idx_atom += idx_arg * pred.strides[i];
+  }
+  return idx_atom;
+}
+
+inline size_t AtomIndex::AtomId(size_t idx_predicate, const size_t* object_ids,
+                                const size_t* idx_args) const {
+  const Predicate& pred = predicates_[idx_predicate];
+  size_t idx_atom = pred.offset;
+  for (size_t i = 0; i < pred.strides.size(); i++) {
+    const size_t idx_arg = pred.idx_objects[i][object_ids[idx_args[i]]];
+    if (idx_arg == kNotFound) return kNotFound;
+    idx_atom += idx_arg * pred.strides[i];
+  }
+  return idx_atom;
+}
+
+}  // namespace logic_opt
+
+#endif  // LOGIC_OPT_PLANNING_ATOM_INDEX_H_
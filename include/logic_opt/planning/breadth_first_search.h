@@ -14,7 +14,9 @@
 #include <iterator>  // std::input_iterator_tag
 #include <queue>     // std::queue
 #include <vector>    // std::vector
-#include <utility>   // std::pair
+
+#include "logic_opt/planning/closed_set.h"
+#include "logic_opt/planning/search_tree.h"
 
 namespace logic_opt {
 
@@ -25,14 +27,17 @@ class BreadthFirstSearch {
 
   class iterator;
 
-  BreadthFirstSearch(const NodeT& root, size_t max_depth) : kMaxDepth(max_depth), root_(root) {}
+  BreadthFirstSearch(const NodeT& root, size_t max_depth,
+                     DuplicateDetection duplicate_detection = DuplicateDetection::kNone)
+      : kMaxDepth(max_depth), kDuplicateDetection(duplicate_detection), root_(root) {}
 
-  iterator begin() { iterator it(root_, kMaxDepth); return ++it; }
+  iterator begin() { iterator it(root_, kMaxDepth, kDuplicateDetection); return ++it; }
   iterator end() { return iterator(); }
 
  private:
 
   const size_t kMaxDepth;
+  const DuplicateDetection kDuplicateDetection;
 
   const NodeT& root_;
 
@@ -50,11 +55,16 @@ class BreadthFirstSearch<NodeT>::iterator {
   using reference = const value_type&;
 
   iterator() {}
-  iterator(const NodeT& root, size_t max_depth)
-      : queue_({{root, std::vector<NodeT>()}}), kMaxDepth(max_depth) {}
+  iterator(const NodeT& root, size_t max_depth, DuplicateDetection duplicate_detection)
+      : kMaxDepth(max_depth), closed_set_(duplicate_detection) {
+    queue_.push(tree_.Add(root));
+    closed_set_.Insert(root, 0);
+  }
 
   iterator& operator++();
-  bool operator==(const iterator& other) const { return queue_.empty() && other.queue_.empty(); }
+  bool operator==(const iterator& other) const {
+    return queue_.empty() && ancestors_.empty() && other.queue_.empty() && other.ancestors_.empty();
+  }
   bool operator!=(const iterator& other) const { return !(*this == other); }
   reference operator*() const { return ancestors_; }
 
@@ -62,31 +72,38 @@ class BreadthFirstSearch<NodeT>::iterator {
 
   const size_t kMaxDepth = 0;
 
-  std::queue<std::pair<NodeT, std::vector<NodeT>>> queue_;
+  SearchTree<NodeT> tree_;
+  std::queue<size_t> queue_;
   std::vector<NodeT> ancestors_;
 
+  ClosedSet<NodeT> closed_set_;
+
 };
 
 template<typename NodeT>
 typename BreadthFirstSearch<NodeT>::iterator& BreadthFirstSearch<NodeT>::iterator::operator++() {
+  // An empty path marks the end, so the last goal is still returned after the frontier empties
+  ancestors_.clear();
   while (!queue_.empty()) {
-    std::pair<NodeT, std::vector<NodeT>>& front = queue_.front();
-
-    // Take ancestors list and append current node
-    ancestors_.swap(front.second);
-    ancestors_.push_back(std::move(front.first));
+    const size_t idx_node = queue_.front();
     queue_.pop();
 
-    // Return if node evaluates to true
-    const NodeT& node = ancestors_.back();
-    if (node) break;
+    // Return path if node evaluates to true
+    const NodeT& node = tree_.node(idx_node);
+    if (node) {
+      ancestors_ = tree_.Path(idx_node);
+      break;
+    }
 
     // Skip children if max depth has been reached
-    if (ancestors_.size() > kMaxDepth) continue;
+    const size_t depth = tree_.depth(idx_node);
+    if (depth >= kMaxDepth) continue;
 
     // Add node's children to queue
     for (const NodeT& child : node) {
-      queue_.emplace(child, ancestors_);
+      // Skip children whose states have already been visited
+      if (!closed_set_.Insert(child, depth + 1)) continue;
+      queue_.push(tree_.Add(child, idx_node));
     }
   }
   return *this;
@@ -0,0 +1,84 @@
+/**
+ * closed_set.h
+ *
+ * Copyright 2026. All Rights Reserved.
+ *
+ * Created: October 17, 2026
+ * Authors: Toki Migimatsu
+ */
+
+#ifndef LOGIC_OPT_PLANNING_CLOSED_SET_H_
+#define LOGIC_OPT_PLANNING_CLOSED_SET_H_
+
+#include <cstddef>        // size_t
+#include <stdexcept>      // std::invalid_argument
+#include <string>         // std::string
+#include <type_traits>    // std::decay_t
+#include <unordered_map>  // std::unordered_map
+#include <utility>        // std::declval
+
+namespace logic_opt {
+
+enum class DuplicateDetection {
+  kNone,        // Tree search: expand every path
+  kFirstVisit,  // Graph search: expand each state once
+  kBestDepth    // Expand each state only along paths no deeper than its shallowest one
+};
+
+inline DuplicateDetection ParseDuplicateDetection(const std::string& name) {
+  if (name == "none") return DuplicateDetection::kNone;
+  if (name == "first_visit") return DuplicateDetection::kFirstVisit;
+  if (name == "best_depth") return DuplicateDetection::kBestDepth;
+  throw std::invalid_argument("ParseDuplicateDetection(): Invalid mode '" + name + "'.");
+}
+
+/**
+ * Transposition table for search nodes, keyed on NodeT::state().
+ *
+ * kBestDepth still enumerates every distinct plan without detours, which is
+ * what lgp needs, whereas kFirstVisit keeps a single path per state. With
+ * depth-limited DFS, kFirstVisit may miss plans that revisit a state at a
+ * shallower depth.
+ */
+template<typename NodeT>
+class ClosedSet {
+
+ public:
+
+  using StateT = std::decay_t<decltype(std::declval<const NodeT&>().state())>;
+
+  ClosedSet(DuplicateDetection mode = DuplicateDetection::kNone) : mode_(mode) {}
+
+  DuplicateDetection mode() const { return mode_; }
+
+  /**
+   * Record a visit to the node at the given depth. Returns false if the node
+   * is a duplicate and should be pruned.
+   */
+  bool Insert(const NodeT& node, size_t depth);
+
+  void Clear() { depths_.clear(); }
+
+ private:
+
+  DuplicateDetection mode_;
+  std::unordered_map<StateT, size_t> depths_;
+
+};
+
+template<typename NodeT>
+bool ClosedSet<NodeT>::Insert(const NodeT& node, size_t depth) {
+  if (mode_ == DuplicateDetection::kNone) return true;
+
+  auto it_inserted = depths_.emplace(node.state(), depth);
+  if (it_inserted.second) return true;
+
+  size_t& best_depth = it_inserted.first->second;
+  if (mode_ == DuplicateDetection::kFirstVisit || depth > best_depth) return false;
+  best_depth = depth;
+  return true;
+}
+
+}  // namespace logic_opt
+
+#endif  // LOGIC_OPT_PLANNING_CLOSED_SET_H_
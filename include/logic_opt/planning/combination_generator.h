@@ -10,13 +10,26 @@
 #ifndef LOGIC_OPT_PLANNING_COMBINATION_GENERATOR_H_
 #define LOGIC_OPT_PLANNING_COMBINATION_GENERATOR_H_
 
-#include <cstddef>      // ptrdiff_t
-#include <iterator>     // std::forward_iterator_tag, std::iterator_traits
+#include <cstddef>      // ptrdiff_t, size_t
+#include <iterator>     // std::bidirectional_iterator_tag, std::iterator_traits
+#include <stdexcept>    // std::out_of_range
 #include <type_traits>  // std::conditional_t, std::is_const
+#include <utility>      // std::pair
 #include <vector>       // std::vector
 
 namespace logic_opt {
 
+/**
+ * Cartesian product of a list of containers, enumerated in mixed-radix order
+ * with the last container varying fastest.
+ *
+ * Each combination has a rank in [0, size()), so iterators can jump to any
+ * combination in O(number of containers) and the range can be split into
+ * chunks for parallel enumeration. Containers must be random access. An
+ * empty list of containers has a single empty combination. Iterators hold
+ * their own copy of the container pointers, so they remain valid after the
+ * generator is copied or destroyed as long as the containers are alive.
+ */
 template<typename ContainerT>
 class CombinationGenerator {
 
@@ -37,16 +50,23 @@ class CombinationGenerator {
   using reverse_iterator = ReverseIterator<iterator>;
   using const_reverse_iterator = ReverseIterator<const_iterator>;
 
+  using ValueT = typename ContainerT::value_type;
+
   CombinationGenerator() {}
 
   CombinationGenerator(const std::vector<ContainerT*>& options) : options_(options) {}
 
-  iterator begin() { return iterator::begin(options_); };
-  iterator end() { return iterator::end(options_); };
-  const_iterator begin() const { return const_iterator::begin(options_); };
-  const_iterator end() const { return const_iterator::end(options_); };
-  const_iterator cbegin() const { return const_iterator::begin(options_); };
-  const_iterator cend() const { return const_iterator::end(options_); };
+  /**
+   * Number of combinations.
+   */
+  size_t size() const;
+
+  iterator begin() { return iterator(options_, 0); };
+  iterator end() { return iterator(options_, size()); };
+  const_iterator begin() const { return const_iterator(options_, 0); };
+  const_iterator end() const { return const_iterator(options_, size()); };
+  const_iterator cbegin() const { return const_iterator(options_, 0); };
+  const_iterator cend() const { return const_iterator(options_, size()); };
 
   reverse_iterator rbegin() { return reverse_iterator(end()); }
   reverse_iterator rend() { return reverse_iterator(begin()); }
@@ -55,6 +75,24 @@ class CombinationGenerator {
   const_reverse_iterator crbegin() const { return const_reverse_iterator(end()); }
   const_reverse_iterator crend() const { return const_reverse_iterator(begin()); }
 
+  /**
+   * Write the combination with the given rank into the output vector. Does
+   * not allocate if the vector already has the right size.
+   */
+  void Combination(size_t rank, std::vector<ValueT>* combination) const;
+
+  std::vector<ValueT> Combination(size_t rank) const {
+    std::vector<ValueT> combination;
+    Combination(rank, &combination);
+    return combination;
+  }
+
+  /**
+   * Split the combinations into at most num_chunks contiguous ranges of
+   * nearly equal size.
+   */
+  std::vector<std::pair<const_iterator, const_iterator>> Split(size_t num_chunks) const;
+
  private:
 
   std::vector<ContainerT*> options_;
@@ -77,21 +115,54 @@ class CombinationGenerator<ContainerT>::Iterator {
   using pointer = typename std::conditional_t<Const, const value_type*, value_type*>;
   using reference = typename std::conditional_t<Const, const value_type&, value_type&>;
 
-  Iterator(const std::vector<ContainerT*>& options, std::vector<IteratorT>&& it_options);
+  Iterator(const std::vector<ContainerT*>& options, size_t rank);
+
+  /**
+   * Rank of the current combination, or size() at the end.
+   */
+  size_t rank() const { return rank_; }
+
+  /**
+   * Index of the current value in each container.
+   */
+  const std::vector<size_t>& digits() const { return digits_; }
 
   Iterator& operator++();
   Iterator& operator--();
+  /**
+   * Moves are clamped to [begin, end] instead of wrapping around.
+   */
+  Iterator& operator+=(difference_type n) {
+    const difference_type rank = static_cast<difference_type>(rank_) + n;
+    Seek(rank < 0 ? 0 : static_cast<size_t>(rank));
+    return *this;
+  }
+  Iterator& operator-=(difference_type n) { return *this += -n; }
+  Iterator operator+(difference_type n) const { Iterator it(*this); return it += n; }
+  Iterator operator-(difference_type n) const { Iterator it(*this); return it -= n; }
+  difference_type operator-(const Iterator& other) const {
+    return static_cast<difference_type>(rank_) - static_cast<difference_type>(other.rank_);
+  }
   bool operator==(const Iterator& other) const;
   bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+  /**
+   * The combination is updated in place as the iterator moves, so the
+   * reference is only valid until the next increment.
+   */
   reference operator*();
 
  private:
 
-  static Iterator begin(const std::vector<ContainerT*>& options);
-  static Iterator end(const std::vector<ContainerT*>& options);
+  /**
+   * Jump to the given rank, or to the end if it is out of range.
+   */
+  void Seek(size_t rank);
 
-  std::vector<ContainerT*> options_;
-  std::vector<IteratorT> it_options_;
+  std::vector<ContainerT*> options_;  // Copied so iterators outlive the generator
+  size_t size_;
+  size_t rank_;
+  std::vector<size_t> digits_;
   std::vector<ValueT> combination_;
 
   friend class CombinationGenerator;
@@ -124,14 +195,69 @@ class CombinationGenerator<ContainerT>::ReverseIterator {
 
 };
 
+template<typename ContainerT>
+size_t CombinationGenerator<ContainerT>::size() const {
+  size_t size = 1;
+  for (const ContainerT* option : options_) {
+    size *= option->size();
+  }
+  return size;
+}
+
+template<typename ContainerT>
+void CombinationGenerator<ContainerT>::Combination(size_t rank,
+                                                   std::vector<ValueT>* combination) const {
+  if (rank >= size()) {
+    throw std::out_of_range("CombinationGenerator::Combination(): Rank out of range.");
+  }
+  combination->resize(options_.size());
+  for (size_t i = options_.size(); i > 0; i--) {
+    const ContainerT& values = *options_[i - 1];
+    (*combination)[i - 1] = values[rank % values.size()];
+    rank /= values.size();
+  }
+}
+
+template<typename ContainerT>
+std::vector<std::pair<typename CombinationGenerator<ContainerT>::const_iterator,
+                      typename CombinationGenerator<ContainerT>::const_iterator>>
+CombinationGenerator<ContainerT>::Split(size_t num_chunks) const {
+  const size_t num_combinations = size();
+  if (num_chunks > num_combinations) num_chunks = num_combinations;
+
+  std::vector<std::pair<const_iterator, const_iterator>> chunks;
+  chunks.reserve(num_chunks);
+  for (size_t i = 0; i < num_chunks; i++) {
+    chunks.emplace_back(const_iterator(options_, i * num_combinations / num_chunks),
+                        const_iterator(options_, (i + 1) * num_combinations / num_chunks));
+  }
+  return chunks;
+}
+
 template<typename ContainerT>
 template<bool Const>
 CombinationGenerator<ContainerT>::Iterator<Const>::Iterator(const std::vector<ContainerT*>& options,
-                                                            std::vector<IteratorT>&& it_options)
-    : options_(options), it_options_(std::move(it_options)), combination_(options_.size()) {
-  if (it_options_.front() == options_.front()->end()) return;
-  for (size_t i = 0; i < options_.size(); i++) {
-    combination_[i] = *it_options_[i];
+                                                            size_t rank)
+    : options_(options), size_(1), rank_(0), digits_(options.size(), 0),
+      combination_(options.size()) {
+  for (const ContainerT* option : options) {
+    size_ *= option->size();
+  }
+  Seek(rank);
+}
+
+template<typename ContainerT>
+template<bool Const>
+void CombinationGenerator<ContainerT>::Iterator<Const>::Seek(size_t rank) {
+  // Leave the digits of the last combination at the end
+  rank_ = rank < size_ ? rank : size_;
+  if (rank_ == size_) return;
+
+  for (size_t i = options_.size(); i > 0; i--) {
+    ContainerT& values = *options_[i - 1];
+    digits_[i - 1] = rank % values.size();
+    combination_[i - 1] = values[digits_[i - 1]];
+    rank /= values.size();
   }
 }
 
@@ -140,27 +266,22 @@ template<bool Const>
 typename CombinationGenerator<ContainerT>::template Iterator<Const>&
 CombinationGenerator<ContainerT>::Iterator<Const>::operator++() {
   // Check for end flag
-  if (options_.empty() || it_options_.front() == options_.front()->end()) return *this;
-
-  for (size_t i = options_.size() - 1; i >= 0; i--) {
-    ContainerT& values = *options_[i];
-    IteratorT& it_value = it_options_[i];
-    ValueT& value = combination_[i];
+  if (rank_ == size_) return *this;
 
-    ++it_value;
+  if (++rank_ == size_) return *this;
+  for (size_t i = options_.size(); i > 0; i--) {
+    ContainerT& values = *options_[i - 1];
+    size_t& digit = digits_[i - 1];
 
-    // Return if param is not the last one in the current digit place
-    if (it_value != values.end()) {
-      value = *it_value;
+    // Return if value is not the last one in the current digit place
+    if (++digit < values.size()) {
+      combination_[i - 1] = values[digit];
       break;
     }
 
-    // For the last combination, leave the index high
-    if (i == 0) break;
-
-    // Reset index to 0 and increment next digit
-    it_value = values.begin();
-    value = *it_value;
+    // Reset digit to 0 and increment next digit
+    digit = 0;
+    combination_[i - 1] = values[digit];
   }
   return *this;
 }
@@ -170,42 +291,28 @@ template<bool Const>
 typename CombinationGenerator<ContainerT>::template Iterator<Const>&
 CombinationGenerator<ContainerT>::Iterator<Const>::operator--() {
   // Don't decrement past beginning
-  if (*this == begin(options_)) return *this;
+  if (rank_ == 0) return *this;
 
-  // Check for end flag
-  if (it_options_.front() == options_.front()->end()) {
-    // Reset
-    for (size_t i = 0; i < options_.size(); i++) {
-      ContainerT& values = *options_[i];
-      IteratorT& it_value = it_options_[i];
-      ValueT& value = combination_[i];
-
-      it_value = --values.end();
-      value = *it_value;
-    }
+  // Digits are not maintained at the end
+  if (rank_ == size_) {
+    Seek(size_ - 1);
     return *this;
   }
 
-  for (size_t i = options_.size() - 1; i >= 0; i--) {
-    ContainerT& values = *options_[i];
-    IteratorT& it_value = it_options_[i];
-    ValueT& value = combination_[i];
+  --rank_;
+  for (size_t i = options_.size(); i > 0; i--) {
+    ContainerT& values = *options_[i - 1];
+    size_t& digit = digits_[i - 1];
 
-    // Return if param is not yet the first one in the current digit place
-    if (it_value != values.begin()) {
-      --it_value;
-      value = *it_value;
+    // Return if value is not yet the first one in the current digit place
+    if (digit > 0) {
+      combination_[i - 1] = values[--digit];
       break;
     }
 
-    it_value = values.end();
-
-    // For the last combination, leave the index high
-    if (i == 0) break;
-
-    // Set index to last assignable value and decrement next digit
-    --it_value;
-    value = *it_value;
+    // Set digit to last value and decrement next digit
+    digit = values.size() - 1;
+    combination_[i - 1] = values[digit];
   }
   return *this;
 }
@@ -213,67 +320,25 @@ CombinationGenerator<ContainerT>::Iterator<Const>::operator--() {
 template<typename ContainerT>
 template<bool Const>
 bool CombinationGenerator<ContainerT>::Iterator<Const>::operator==(const Iterator& other) const {
-  // Check if empty
-  if (options_.empty() && other.options_.empty()) return true;
-
-  // Check if options are equal
-  if (options_.size() != other.options_.size()) return false;
-  for (size_t i = 0; i < options_.size(); i++) {
-    if (options_[i] != other.options_[i]) return false;
-  }
-
-  // Check end flag
-  if (it_options_.front() == options_.front()->end() &&
-      other.it_options_.front() == other.options_.front()->end()) return true;
-
-  // Check iterator positions
-  for (size_t i = 0; i < options_.size(); i++) {
-    if (it_options_[i] != other.it_options_[i]) return false;
-  }
-  return true;
+  return rank_ == other.rank_ && options_ == other.options_;
 }
 
 template<typename ContainerT>
 template<bool Const>
 typename CombinationGenerator<ContainerT>::template Iterator<Const>::reference
 CombinationGenerator<ContainerT>::Iterator<Const>::operator*() {
-  if (options_.empty()) return combination_;
-  if (it_options_.front() == options_.front()->end()) {
-    throw std::out_of_range("ParameterGenerator::iterator::operator*(): Cannot dereference.");
+  if (rank_ == size_) {
+    throw std::out_of_range("CombinationGenerator::iterator::operator*(): Cannot dereference.");
   }
   return combination_;
 }
 
-template<typename ContainerT>
-template<bool Const>
-typename CombinationGenerator<ContainerT>::template Iterator<Const>
-CombinationGenerator<ContainerT>::Iterator<Const>::begin(const std::vector<ContainerT*>& options) {
-  std::vector<IteratorT> it_options;
-  it_options.reserve(options.size());
-  for (ContainerT* option : options) {
-    it_options.push_back(option->begin());
-  }
-  return Iterator(options, std::move(it_options));
-}
-
-template<typename ContainerT>
-template<bool Const>
-typename CombinationGenerator<ContainerT>::template Iterator<Const>
-CombinationGenerator<ContainerT>::Iterator<Const>::end(const std::vector<ContainerT*>& options) {
-  std::vector<IteratorT> it_options;
-  it_options.reserve(options.size());
-  for (ContainerT* option : options) {
-    it_options.push_back(option->end());
-  }
-  return Iterator(options, std::move(it_options));
-}
-
 template<typename ContainerT>
 template<typename IteratorT>
 CombinationGenerator<ContainerT>::ReverseIterator<IteratorT>::ReverseIterator(IteratorT&& it)
     : it_(std::move(it)) {
-  if (it_ == IteratorT::begin(it_.options_)) {
-    it_ = IteratorT::end(it_.options_);
+  if (it_.rank_ == 0) {
+    it_.Seek(it_.size_);
   } else {
     --it_;
   }
@@ -283,9 +348,9 @@ template<typename ContainerT>
 template<typename IteratorT>
 typename CombinationGenerator<ContainerT>::template ReverseIterator<IteratorT>&
 CombinationGenerator<ContainerT>::ReverseIterator<IteratorT>::operator++() {
-  if (it_ == IteratorT::begin(it_.options_)) {
-    it_ = IteratorT::end(it_.options_);
-  } else if (it_ != IteratorT::end(it_.options_)) {
+  if (it_.rank_ == 0) {
+    it_.Seek(it_.size_);
+  } else if (it_.rank_ != it_.size_) {
     --it_;
   }
   return *this;
@@ -295,8 +360,8 @@ template<typename ContainerT>
 template<typename IteratorT>
 typename CombinationGenerator<ContainerT>::template ReverseIterator<IteratorT>&
 CombinationGenerator<ContainerT>::ReverseIterator<IteratorT>::operator--() {
-  if (it_ == IteratorT::end(it_.options_)) {
-    it_ = IteratorT::begin(it_.options_);
+  if (it_.rank_ == it_.size_) {
+    it_.Seek(0);
   } else {
     ++it_;
   }
@@ -16,6 +16,9 @@
 #include <vector>    // std::vector
 #include <utility>   // std::pair
 
+#include "logic_opt/planning/closed_set.h"
+#include "logic_opt/planning/search_tree.h"
+
 namespace logic_opt {
 
 template<typename NodeT>
@@ -25,14 +28,17 @@ class DepthFirstSearch {
 
   class iterator;
 
-  DepthFirstSearch(const NodeT& root, size_t max_depth) : kMaxDepth(max_depth), root_(root) {}
+  DepthFirstSearch(const NodeT& root, size_t max_depth,
+                   DuplicateDetection duplicate_detection = DuplicateDetection::kNone)
+      : kMaxDepth(max_depth), kDuplicateDetection(duplicate_detection), root_(root) {}
 
-  iterator begin() { iterator it(root_, kMaxDepth); return ++it; }
+  iterator begin() { iterator it(root_, kMaxDepth, kDuplicateDetection); return ++it; }
   iterator end() { return iterator(); }
 
  private:
 
   const size_t kMaxDepth;
+  const DuplicateDetection kDuplicateDetection;
 
   const NodeT& root_;
 
@@ -50,11 +56,16 @@ class DepthFirstSearch<NodeT>::iterator {
   using reference = const value_type&;
 
   iterator() {}
-  iterator(const NodeT& root, size_t max_depth)
-      : stack_({{root, std::vector<NodeT>()}}), kMaxDepth(max_depth) {}
+  iterator(const NodeT& root, size_t max_depth, DuplicateDetection duplicate_detection)
+      : kMaxDepth(max_depth), stack_({{root, SearchTree<NodeT>::kNoParent}}),
+        closed_set_(duplicate_detection) {
+    closed_set_.Insert(root, 0);
+  }
 
   iterator& operator++();
-  bool operator==(const iterator& other) const { return stack_.empty() && other.stack_.empty(); }
+  bool operator==(const iterator& other) const {
+    return stack_.empty() && ancestors_.empty() && other.stack_.empty() && other.ancestors_.empty();
+  }
   bool operator!=(const iterator& other) const { return !(*this == other); }
   reference operator*() const { return ancestors_; }
 
@@ -62,32 +73,46 @@ class DepthFirstSearch<NodeT>::iterator {
 
   const size_t kMaxDepth = 0;
 
-  std::stack<std::pair<NodeT, std::vector<NodeT>>> stack_;
+  // Only the current path is kept in the tree, and stack entries refer to
+  // their parents on that path
+  SearchTree<NodeT> tree_;
+  std::stack<std::pair<NodeT, size_t>> stack_;
   std::vector<NodeT> ancestors_;
 
+  ClosedSet<NodeT> closed_set_;
+
 };
 
 template<typename NodeT>
 typename DepthFirstSearch<NodeT>::iterator& DepthFirstSearch<NodeT>::iterator::operator++() {
+  // An empty path marks the end, so the last goal is still returned after the frontier empties
+  ancestors_.clear();
   while (!stack_.empty()) {
-    std::pair<NodeT, std::vector<NodeT>>& top = stack_.top();
+    std::pair<NodeT, size_t>& top = stack_.top();
 
-    // Take ancestors list and append current node
-    ancestors_.swap(top.second);
-    ancestors_.push_back(std::move(top.first));
+    // Discard finished branches and append node to the current path
+    const size_t idx_parent = top.second;
+    tree_.Truncate(idx_parent == SearchTree<NodeT>::kNoParent ? 0 : idx_parent + 1);
+    const size_t idx_node = tree_.Add(std::move(top.first), idx_parent);
     stack_.pop();
 
-    // Return if node evaluates to true
-    const NodeT& node = ancestors_.back();
-    if (node) break;
+    // Return path if node evaluates to true
+    const NodeT& node = tree_.node(idx_node);
+    if (node) {
+      ancestors_ = tree_.Path(idx_node);
+      break;
+    }
 
     // Skip children if max depth has been reached
-    if (ancestors_.size() > kMaxDepth) continue;
+    const size_t depth = tree_.depth(idx_node);
+    if (depth >= kMaxDepth) continue;
 
     // Add node's children to stack
     // TODO: iterate backwards so children get visited in order
     for (const NodeT& child : node) {
-      stack_.emplace(child, ancestors_);
+      // Skip children whose states have already been visited
+      if (!closed_set_.Insert(child, depth + 1)) continue;
+      stack_.emplace(child, idx_node);
     }
   }
   return *this;
@@ -0,0 +1,159 @@
+/**
+ * grounding.h
+ *
+ * Copyright 2026. All Rights Reserved.
+ *
+ * Created: October 17, 2026
+ * Authors: Toki Migimatsu
+ */
+
+#ifndef LOGIC_OPT_PLANNING_GROUNDING_H_
+#define LOGIC_OPT_PLANNING_GROUNDING_H_
+
+#include <vector>  // std::vector
+
+#include "ptree.h"
+
+#include "logic_opt/planning/atom_index.h"
+#include "logic_opt/planning/proposition.h"
+#include "logic_opt/planning/state.h"
+
+namespace logic_opt {
+
+/**
+ * Conjunction of grounded literals.
+ */
+struct GroundConjunction {
+
+  bool IsSatisfied(const State& state) const {
+    for (size_t idx_atom : pos) {
+      if (!state.Contains(idx_atom)) return false;
+    }
+    for (size_t idx_atom : neg) {
+      if (state.Contains(idx_atom)) return false;
+    }
+    return true;
+  }
+
+  std::vector<size_t> pos;  // Atoms that must be true
+  std::vector<size_t> neg;  // Atoms that must be false
+
+};
+
+/**
+ * Grounded formula in disjunctive normal form.
+ *
+ * Literals over static predicates (those not modified by any action) and
+ * equality are evaluated at ground time, so a condition with no terms is
+ * unsatisfiable and a condition with an empty term is always satisfied.
+ *
+ * Conjunctions whose expansion would exceed a size limit are not distributed
+ * into the terms. Instead, the condition keeps nested subconditions and holds
+ * when (some term or some disjunct) holds and all conjuncts hold.
+ */
+struct GroundCondition {
+
+  bool IsSatisfied(const State& state) const {
+    for (const GroundCondition& conjunct : conjuncts) {
+      if (!conjunct.IsSatisfied(state)) return false;
+    }
+    for (const GroundConjunction& term : terms) {
+      if (term.IsSatisfied(state)) return true;
+    }
+    for (const GroundCondition& disjunct : disjuncts) {
+      if (disjunct.IsSatisfied(state)) return true;
+    }
+    return false;
+  }
+
+  bool IsTrue() const;
+  bool IsFalse() const { return terms.empty() && disjuncts.empty(); }
+
+  std::vector<GroundConjunction> terms;
+  std::vector<GroundCondition> disjuncts;  // Nested alternatives to terms
+  std::vector<GroundCondition> conjuncts;  // Nested conditions that must also hold
+
+};
+
+/**
+ * Conditional effect of a grounded action.
+ */
+struct GroundEffect {
+
+  GroundCondition condition;
+  std::vector<size_t> add;
+  std::vector<size_t> del;
+
+};
+
+/**
+ * Operator with all parameters (including forall effects) bound to objects.
+ */
+class GroundAction {
+
+ public:
+
+  GroundAction(const VAL::operator_* op, std::vector<const VAL::parameter_symbol*>&& args)
+      : symbol_(op), proposition_(op->name->getName(), std::move(args)) {}
+
+  const VAL::operator_* symbol() const { return symbol_; }
+
+  const Proposition& proposition() const { return proposition_; }
+
+  const GroundCondition& precondition() const { return precondition_; }
+
+  const std::vector<size_t>& add() const { return add_; }
+  const std::vector<size_t>& del() const { return del_; }
+  const std::vector<GroundEffect>& cond_effects() const { return cond_effects_; }
+
+  bool IsApplicable(const State& state) const { return precondition_.IsSatisfied(state); }
+
+  /**
+   * Apply the effects whose conditions hold in the given state. All deletes
+   * are applied before all adds, so an atom that is both deleted and added
+   * remains true.
+   */
+  State Apply(const State& state) const;
+
+ private:
+
+  const VAL::operator_* symbol_;
+  Proposition proposition_;
+
+  GroundCondition precondition_;
+  std::vector<size_t> add_;
+  std::vector<size_t> del_;
+  std::vector<GroundEffect> cond_effects_;
+
+  friend std::vector<GroundAction> GroundActions(const VAL::domain*, const AtomIndex&, const State&);
+  friend GroundAction GroundOperator(const VAL::domain*, const AtomIndex&, const VAL::operator_*,
+                                     const std::vector<const VAL::parameter_symbol*>&);
+
+};
+
+/**
+ * Enumerate all type-correct operator instantiations whose preconditions are
+ * consistent with the static atoms of the initial state and reachable under
+ * the delete relaxation. Actions are returned in operator order, then in
+ * ParameterGenerator order.
+ */
+std::vector<GroundAction> GroundActions(const VAL::domain* domain, const AtomIndex& atoms,
+                                        const State& initial_state);
+
+/**
+ * Ground a single operator instantiation. Unlike GroundActions(), static
+ * predicates are kept as literals, so the result is valid in any state.
+ */
+GroundAction GroundOperator(const VAL::domain* domain, const AtomIndex& atoms,
+                            const VAL::operator_* op,
+                            const std::vector<const VAL::parameter_symbol*>& args);
+
+/**
+ * Ground the problem goal.
+ */
+GroundCondition GroundGoal(const VAL::domain* domain, const VAL::problem* problem,
+                           const AtomIndex& atoms, const State& initial_state);
+
+}  // namespace logic_opt
+
+#endif  // LOGIC_OPT_PLANNING_GROUNDING_H_
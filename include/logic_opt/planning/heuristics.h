@@ -0,0 +1,91 @@
+/**
+ * heuristics.h
+ *
+ * Copyright 2026. All Rights Reserved.
+ *
+ * Created: October 17, 2026
+ * Authors: Toki Migimatsu
+ */
+
+#ifndef LOGIC_OPT_PLANNING_HEURISTICS_H_
+#define LOGIC_OPT_PLANNING_HEURISTICS_H_
+
+#include <cstddef>  // size_t
+#include <limits>   // std::numeric_limits
+#include <string>   // std::string
+#include <vector>   // std::vector
+
+#include "logic_opt/planning/grounding.h"
+#include "logic_opt/planning/state.h"
+
+namespace logic_opt {
+
+enum class HeuristicType {
+  kMax,  // Cost of the most expensive goal atom
+  kAdd,  // Sum of goal atom costs (inadmissible)
+  kFF    // Length of a relaxed plan extracted from the h_add supporters (inadmissible)
+};
+
+HeuristicType ParseHeuristicType(const std::string& name);
+
+/**
+ * Delete relaxation of the grounded task with unit action costs.
+ *
+ * Negative preconditions, delete effects and negative goals are ignored.
+ * Disjunctive conditions become one relaxed operator per DNF term, and
+ * conditional effects become operators whose precondition is the conjunction
+ * of the action precondition and the effect condition. Nested conjuncts of
+ * conditions too large to expand are dropped.
+ *
+ * Evaluate() only uses local buffers, so one graph may be shared between
+ * threads.
+ */
+class RelaxedPlanningGraph {
+
+ public:
+
+  static constexpr size_t kInfinity = std::numeric_limits<size_t>::max();
+
+  RelaxedPlanningGraph(const std::vector<GroundAction>& actions, const GroundCondition& goal,
+                       size_t num_atoms, HeuristicType type = HeuristicType::kFF);
+
+  HeuristicType type() const { return type_; }
+
+  /**
+   * Estimated number of actions to reach the goal from the state, or
+   * kInfinity if the goal is unreachable even under the relaxation.
+   */
+  size_t Evaluate(const State& state) const { return Evaluate(state, type_); }
+
+  size_t Evaluate(const State& state, HeuristicType type) const;
+
+ private:
+
+  struct Operator {
+    std::vector<size_t> pre;
+    std::vector<size_t> add;
+    size_t idx_action;
+  };
+
+  /**
+   * Compute relaxed atom costs until the cheapest goal term is resolved.
+   * Returns the index of that goal term, or kInfinity.
+   */
+  size_t ComputeCosts(const State& state, bool is_additive, std::vector<size_t>& costs,
+                      std::vector<size_t>& supporters, size_t& goal_cost) const;
+
+  size_t ExtractRelaxedPlan(size_t idx_goal, const std::vector<size_t>& costs,
+                            const std::vector<size_t>& supporters) const;
+
+  const HeuristicType type_;
+  const size_t num_actions_;
+
+  std::vector<Operator> operators_;          // Relaxed actions followed by goal terms
+  std::vector<std::vector<size_t>> atom_operators_;  // Operators with each atom as a precondition
+  size_t idx_goals_;                         // Index of the first goal term in operators_
+
+};
+
+}  // namespace logic_opt
+
+#endif  // LOGIC_OPT_PLANNING_HEURISTICS_H_
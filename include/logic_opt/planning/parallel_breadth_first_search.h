@@ -0,0 +1,171 @@
+/**
+ * parallel_breadth_first_search.h
+ *
+ * Copyright 2026. All Rights Reserved.
+ *
+ * Created: October 17, 2026
+ * Authors: Toki Migimatsu
+ */
+
+#ifndef LOGIC_OPT_PLANNING_PARALLEL_BREADTH_FIRST_SEARCH_H_
+#define LOGIC_OPT_PLANNING_PARALLEL_BREADTH_FIRST_SEARCH_H_
+
+#include <algorithm>  // std::max, std::min
+#include <atomic>     // std::atomic
+#include <cstddef>    // ptrdiff_t
+#include <iterator>   // std::input_iterator_tag
+#include <thread>     // std::thread
+#include <utility>    // std::move
+#include <vector>     // std::vector
+
+#include "logic_opt/planning/closed_set.h"
+#include "logic_opt/planning/search_tree.h"
+
+namespace logic_opt {
+
+/**
+ * Level-synchronous breadth-first search.
+ *
+ * Each level of the frontier is expanded by a pool of threads, after which the
+ * children are merged into the search tree on the calling thread in parent
+ * order. Plans are therefore returned in exactly the same order as
+ * BreadthFirstSearch, regardless of the number of threads. NodeT iteration
+ * must be safe to call concurrently on distinct nodes.
+ */
+template<typename NodeT>
+class ParallelBreadthFirstSearch {
+
+ public:
+
+  class iterator;
+
+  /**
+   * @param num_threads Number of expansion threads. 0 uses all hardware threads.
+   */
+  ParallelBreadthFirstSearch(const NodeT& root, size_t max_depth,
+                             DuplicateDetection duplicate_detection = DuplicateDetection::kNone,
+                             size_t num_threads = 0)
+      : kMaxDepth(max_depth), kDuplicateDetection(duplicate_detection),
+        kNumThreads(num_threads > 0 ? num_threads
+                                    : std::max<size_t>(1, std::thread::hardware_concurrency())),
+        root_(root) {}
+
+  iterator begin() { iterator it(root_, kMaxDepth, kDuplicateDetection, kNumThreads); return ++it; }
+  iterator end() { return iterator(); }
+
+ private:
+
+  const size_t kMaxDepth;
+  const DuplicateDetection kDuplicateDetection;
+  const size_t kNumThreads;
+
+  const NodeT& root_;
+
+};
+
+template<typename NodeT>
+class ParallelBreadthFirstSearch<NodeT>::iterator {
+
+ public:
+
+  using iterator_category = std::input_iterator_tag;
+  using value_type = std::vector<NodeT>;
+  using difference_type = ptrdiff_t;
+  using pointer = const value_type*;
+  using reference = const value_type&;
+
+  iterator() {}
+  iterator(const NodeT& root, size_t max_depth, DuplicateDetection duplicate_detection,
+           size_t num_threads)
+      : kMaxDepth(max_depth), kNumThreads(num_threads), closed_set_(duplicate_detection) {
+    level_.push_back(tree_.Add(root));
+    closed_set_.Insert(root, 0);
+  }
+
+  iterator& operator++();
+  bool operator==(const iterator& other) const { return level_.empty() && other.level_.empty(); }
+  bool operator!=(const iterator& other) const { return !(*this == other); }
+  reference operator*() const { return ancestors_; }
+
+ private:
+
+  /**
+   * Replace the current level with the children of the frontier.
+   */
+  void ExpandFrontier();
+
+  const size_t kMaxDepth = 0;
+  const size_t kNumThreads = 1;
+
+  SearchTree<NodeT> tree_;
+  std::vector<size_t> level_;     // Nodes at the current depth
+  size_t idx_level_ = 0;          // Next node in level_ to check
+  std::vector<size_t> frontier_;  // Non-goal nodes in level_ to expand
+  std::vector<NodeT> ancestors_;
+
+  ClosedSet<NodeT> closed_set_;
+
+};
+
+template<typename NodeT>
+typename ParallelBreadthFirstSearch<NodeT>::iterator&
+ParallelBreadthFirstSearch<NodeT>::iterator::operator++() {
+  while (!level_.empty()) {
+    // Return paths for the remaining goal nodes in the current level
+    while (idx_level_ < level_.size()) {
+      const size_t idx_node = level_[idx_level_++];
+      if (tree_.node(idx_node)) {
+        ancestors_ = tree_.Path(idx_node);
+        return *this;
+      }
+
+      // Skip children if max depth has been reached
+      if (tree_.depth(idx_node) < kMaxDepth) frontier_.push_back(idx_node);
+    }
+
+    ExpandFrontier();
+  }
+  return *this;
+}
+
+template<typename NodeT>
+void ParallelBreadthFirstSearch<NodeT>::iterator::ExpandFrontier() {
+  // Generate children in parallel
+  std::vector<std::vector<NodeT>> children(frontier_.size());
+  std::atomic<size_t> idx_next(0);
+  auto Expand = [this, &children, &idx_next]() {
+    for (size_t i = idx_next++; i < frontier_.size(); i = idx_next++) {
+      for (const NodeT& child : tree_.node(frontier_[i])) {
+        children[i].push_back(child);
+      }
+    }
+  };
+
+  const size_t num_threads = std::min(kNumThreads, frontier_.size());
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads > 0 ? num_threads - 1 : 0);
+  for (size_t i = 1; i < num_threads; i++) {
+    threads.emplace_back(Expand);
+  }
+  Expand();
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  // Merge children in parent order so that results are deterministic
+  level_.clear();
+  idx_level_ = 0;
+  for (size_t i = 0; i < frontier_.size(); i++) {
+    const size_t depth = tree_.depth(frontier_[i]) + 1;
+    for (NodeT& child : children[i]) {
+      // Skip children whose states have already been visited
+      if (!closed_set_.Insert(child, depth)) continue;
+      level_.push_back(tree_.Add(std::move(child), frontier_[i]));
+    }
+  }
+  frontier_.clear();
+}
+
+}  // namespace logic_opt
+
+#endif  // LOGIC_OPT_PLANNING_PARALLEL_BREADTH_FIRST_SEARCH_H_
@@ -12,14 +12,16 @@
 
 #include <memory>    // std::shared_ptr
 #include <iostream>  // std::ostream
-#include <set>       // std::ostream
+#include <set>       // std::set
 #include <vector>    // std::vector
 
 #include "ptree.h"
 
-#include "logic_opt/planning/formula.h"
+#include "logic_opt/planning/atom_index.h"
+#include "logic_opt/planning/grounding.h"
 #include "logic_opt/planning/objects.h"
 #include "logic_opt/planning/proposition.h"
+#include "logic_opt/planning/state.h"
 
 namespace logic_opt {
 
@@ -35,11 +37,21 @@ class Planner {
     class reverse_iterator;
 
     Node(const Planner* planner, size_t depth) : planner_(planner), depth_(depth) {}
-    Node(const Planner* planner, std::set<Proposition>&& propositions, size_t depth = 0);
+    Node(const Planner* planner, State&& state, size_t depth = 0);
 
-    const Proposition& action() const { return action_; }
+    const Proposition& action() const;
 
-    const std::set<Proposition>& propositions() const { return propositions_; }
+    /**
+     * Grounded action that generated this node, or nullptr for the root.
+     */
+    const GroundAction* ground_action() const { return action_; }
+
+    const State& state() const { return state_; }
+
+    /**
+     * Decode the state into propositions (excluding equality).
+     */
+    std::set<Proposition> propositions() const;
 
     iterator begin() const;
     iterator end() const;
@@ -49,8 +61,8 @@ class Planner {
    private:
 
     const Planner* planner_;
-    Proposition action_;
-    std::set<Proposition> propositions_;
+    const GroundAction* action_ = nullptr;
+    State state_;
     size_t depth_;
 
     friend std::ostream& operator<<(std::ostream&, const Planner::Node&);
@@ -63,17 +75,22 @@ class Planner {
 
   const ObjectTypeMap& objects() const { return *objects_; }
 
+  const AtomIndex& atoms() const { return *atoms_; }
+
+  const std::vector<GroundAction>& actions() const { return actions_; }
+
+  const GroundCondition& goal() const { return goal_; }
+
  private:
 
-  mutable FormulaMap formulas_;
   const std::shared_ptr<const ObjectTypeMap> objects_;
-  const VAL::operator_list& operators_;
-  const VAL::goal* goal_;
-  const VAL::parameter_symbol_list goal_params_;
-  const std::vector<const VAL::parameter_symbol*> goal_args_;
+  const std::shared_ptr<const AtomIndex> atoms_;
 
   Node root_;
 
+  const std::vector<GroundAction> actions_;
+  const GroundCondition goal_;
+
 };
 
 std::ostream& operator<<(std::ostream& os, const logic_opt::Planner::Node& node);
@@ -103,10 +120,7 @@ class Planner::Node::iterator {
   const Node* parent_;
   Node child_;
 
-  VAL::operator_list::const_iterator it_op_;
-
-  ParameterGenerator param_gen_;
-  ParameterGenerator::const_iterator it_param_;
+  std::vector<GroundAction>::const_iterator it_action_;
 
   friend class Node;
 
@@ -10,19 +10,30 @@
 #ifndef LOGIC_OPT_PLANNING_PROPOSITION_H_
 #define LOGIC_OPT_PLANNING_PROPOSITION_H_
 
-#include <ostream>  // std::ostream
-#include <vector>   // std::vector
-#include <string>   // std::string
+#include <cstddef>     // size_t
+#include <functional>  // std::hash
+#include <ostream>     // std::ostream
+#include <vector>      // std::vector
+#include <string>      // std::string
 
 #include "ptree.h"
 
 namespace logic_opt {
 
+/**
+ * Predicate applied to objects.
+ *
+ * Predicate names are interned in a global table, so propositions only hold
+ * a pointer to the shared name. Each thread caches its lookups, so the table
+ * is only locked the first time a thread sees a predicate. Equal predicates are compared by pointer, and
+ * names are only compared to order different predicates. The hash is
+ * computed once on construction.
+ */
 class Proposition {
 
  public:
 
-  Proposition() {}
+  Proposition();
 
   Proposition(const VAL::proposition* predicate,
               std::vector<const VAL::parameter_symbol*>&& a_variables);
@@ -34,9 +45,11 @@ class Proposition {
               const std::vector<const VAL::parameter_symbol*>& a_variables);
 
   // Properties
-  const std::string& predicate() const { return predicate_; }
+  const std::string& predicate() const { return *predicate_; }
   const std::vector<const VAL::parameter_symbol*>& variables() const { return variables_; }
 
+  size_t hash() const { return hash_; }
+
   // Operators
   bool operator<(const Proposition& rhs) const;
   bool operator==(const Proposition& rhs) const;
@@ -44,8 +57,13 @@ class Proposition {
 
  private:
 
-  std::string predicate_;
+  static const std::string* InternPredicate(const std::string& name_predicate);
+
+  size_t ComputeHash() const;
+
+  const std::string* predicate_;
   std::vector<const VAL::parameter_symbol*> variables_;
+  size_t hash_;
 
 };
 
@@ -53,4 +71,13 @@ std::ostream& operator<<(std::ostream& os, const logic_opt::Proposition& P);
 
 }  // namespace logic_opt
 
+namespace std {
+
+template<>
+struct hash<logic_opt::Proposition> {
+  size_t operator()(const logic_opt::Proposition& P) const { return P.hash(); }
+};
+
+}  // namespace std
+
 #endif  // LOGIC_OPT_PLANNING_PROPOSITION_H_
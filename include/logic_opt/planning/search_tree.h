@@ -0,0 +1,100 @@
+/**
+ * search_tree.h
+ *
+ * Copyright 2026. All Rights Reserved.
+ *
+ * Created: October 17, 2026
+ * Authors: Toki Migimatsu
+ */
+
+#ifndef LOGIC_OPT_PLANNING_SEARCH_TREE_H_
+#define LOGIC_OPT_PLANNING_SEARCH_TREE_H_
+
+#include <algorithm>  // std::reverse
+#include <cstddef>    // size_t
+#include <deque>      // std::deque
+#include <limits>     // std::numeric_limits
+#include <utility>    // std::move
+#include <vector>     // std::vector
+
+namespace logic_opt {
+
+/**
+ * Arena of search nodes linked to their parents by index.
+ *
+ * Entries are stored in a deque so that references to nodes stay valid while
+ * their children are being added. Plans are only materialized by walking the
+ * parent links when a goal is found.
+ */
+template<typename NodeT>
+class SearchTree {
+
+ public:
+
+  static constexpr size_t kNoParent = std::numeric_limits<size_t>::max();
+
+  size_t size() const { return entries_.size(); }
+
+  const NodeT& node(size_t idx_node) const { return entries_[idx_node].node; }
+
+  size_t parent(size_t idx_node) const { return entries_[idx_node].idx_parent; }
+
+  size_t depth(size_t idx_node) const { return entries_[idx_node].depth; }
+
+  /**
+   * Add a node under the given parent and return its index.
+   */
+  size_t Add(const NodeT& node, size_t idx_parent = kNoParent) {
+    entries_.push_back({ node, idx_parent, Depth(idx_parent) });
+    return entries_.size() - 1;
+  }
+
+  size_t Add(NodeT&& node, size_t idx_parent = kNoParent) {
+    entries_.push_back({ std::move(node), idx_parent, Depth(idx_parent) });
+    return entries_.size() - 1;
+  }
+
+  /**
+   * Remove all nodes with index >= size. Used by DFS to discard finished branches.
+   */
+  void Truncate(size_t size) {
+    if (size < entries_.size()) entries_.erase(entries_.begin() + size, entries_.end());
+  }
+
+  void Clear() { entries_.clear(); }
+
+  /**
+   * Nodes from the root to the given node.
+   */
+  std::vector<NodeT> Path(size_t idx_node) const {
+    std::vector<NodeT> path;
+    path.reserve(depth(idx_node) + 1);
+    for (size_t idx = idx_node; idx != kNoParent; idx = parent(idx)) {
+      path.push_back(node(idx));
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+  }
+
+ private:
+
+  size_t Depth(size_t idx_parent) const {
+    return idx_parent == kNoParent ? 0 : entries_[idx_parent].depth + 1;
+  }
+
+  struct Entry {
+    NodeT node;
+    size_t idx_parent;
+    size_t depth;
+  };
+
+  std::deque<Entry> entries_;
+
+};
+
+template<typename NodeT>
+constexpr size_t SearchTree<NodeT>::kNoParent;
+
+}  // namespace logic_opt
+
+#endif  // LOGIC_OPT_PLANNING_SEARCH_TREE_H_
@@ -0,0 +1,119 @@
+/**
+ * state.h
+ *
+ * Copyright 2026. All Rights Reserved.
+ *
+ * Created: October 17, 2026
+ * Authors: Toki Migimatsu
+ */
+
+#ifndef LOGIC_OPT_PLANNING_STATE_H_
+#define LOGIC_OPT_PLANNING_STATE_H_
+
+#include <cstddef>     // size_t
+#include <cstdint>     // uint64_t
+#include <functional>  // std::hash
+#include <vector>      // std::vector
+
+namespace logic_opt {
+
+/**
+ * Dense bitset over grounded atom ids (see AtomIndex).
+ *
+ * Bit i is set iff atom i is true. All states created from the same AtomIndex
+ * have the same width, so set operations reduce to word-wide loops.
+ */
+class State {
+
+ public:
+
+  State() {}
+
+  explicit State(size_t num_atoms)
+      : num_atoms_(num_atoms), words_((num_atoms + kBitsPerWord - 1) / kBitsPerWord, 0) {}
+
+  size_t size() const { return num_atoms_; }
+
+  const std::vector<uint64_t>& words() const { return words_; }
+
+  // Single atoms
+  bool Contains(size_t idx_atom) const {
+    return (words_[idx_atom / kBitsPerWord] >> (idx_atom % kBitsPerWord)) & 1;
+  }
+
+  void Add(size_t idx_atom) {
+    words_[idx_atom / kBitsPerWord] |= uint64_t(1) << (idx_atom % kBitsPerWord);
+  }
+
+  void Remove(size_t idx_atom) {
+    words_[idx_atom / kBitsPerWord] &= ~(uint64_t(1) << (idx_atom % kBitsPerWord));
+  }
+
+  // Atom sets
+  /**
+   * Test whether all atoms in the other state are contained in this one.
+   */
+  bool Contains(const State& other) const {
+    for (size_t i = 0; i < words_.size(); i++) {
+      if ((words_[i] & other.words_[i]) != other.words_[i]) return false;
+    }
+    return true;
+  }
+
+  bool Intersects(const State& other) const {
+    for (size_t i = 0; i < words_.size(); i++) {
+      if (words_[i] & other.words_[i]) return true;
+    }
+    return false;
+  }
+
+  void Add(const State& other) {
+    for (size_t i = 0; i < words_.size(); i++) {
+      words_[i] |= other.words_[i];
+    }
+  }
+
+  void Remove(const State& other) {
+    for (size_t i = 0; i < words_.size(); i++) {
+      words_[i] &= ~other.words_[i];
+    }
+  }
+
+  size_t Hash() const {
+    // Mix each word with the splitmix64 finalizer
+    uint64_t h = num_atoms_;
+    for (uint64_t word : words_) {
+      uint64_t z = word + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+      z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+      z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+      h ^= z ^ (z >> 31);
+    }
+    return static_cast<size_t>(h);
+  }
+
+  // Operators
+  bool operator==(const State& rhs) const { return words_ == rhs.words_; }
+  bool operator!=(const State& rhs) const { return words_ != rhs.words_; }
+  bool operator<(const State& rhs) const { return words_ < rhs.words_; }
+
+ private:
+
+  static constexpr size_t kBitsPerWord = 64;
+
+  size_t num_atoms_ = 0;
+  std::vector<uint64_t> words_;
+
+};
+
+}  // namespace logic_opt
+
+namespace std {
+
+template<>
+struct hash<logic_opt::State> {
+  size_t operator()(const logic_opt::State& state) const { return state.Hash(); }
+};
+
+}  // namespace std
+
+#endif  // LOGIC_OPT_PLANNING_STATE_H_
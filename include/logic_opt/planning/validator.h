@@ -10,14 +10,20 @@
 #ifndef LOGIC_OPT_PLANNING_VALIDATOR_H_
 #define LOGIC_OPT_PLANNING_VALIDATOR_H_
 
-#include <set>     // std::set
-#include <string>  // std::string
-#include <vector>  // std::vector
+#include <map>            // std::map
+#include <set>            // std::set
+#include <string>         // std::string
+#include <unordered_map>  // std::unordered_map
+#include <utility>        // std::pair
+#include <vector>         // std::vector
 
 #include "ptree.h"
 
+#include "logic_opt/planning/atom_index.h"
 #include "logic_opt/planning/formula.h"
+#include "logic_opt/planning/grounding.h"
 #include "logic_opt/planning/proposition.h"
+#include "logic_opt/planning/state.h"
 
 namespace logic_opt {
 
@@ -47,7 +53,12 @@ class Validator {
 
   std::vector<const VAL::parameter_symbol*> GetValArguments(const std::string& atom) const;
   Proposition GetProposition(const std::string& proposition) const;
-  std::set<Proposition> GetPropositions(const std::set<std::string>& state) const;
+  State GetState(const std::set<std::string>& state) const;
+
+  /**
+   * Ground the action on first use and cache it.
+   */
+  const GroundAction& GetGroundAction(const std::string& action_call) const;
 
   const std::unique_ptr<VAL::analysis> analysis_;
   const VAL::domain* domain_;
@@ -55,12 +66,20 @@ class Validator {
 
   // TODO: Consolidate
   const std::shared_ptr<const ObjectTypeMap> objects_;
+  const std::shared_ptr<const AtomIndex> atoms_;
   const VAL::parameter_symbol_list list_objects_;
   const std::vector<const VAL::parameter_symbol*> vec_objects_;
 
+  // Propositions rendered as strings, indexed by atom id
+  const std::vector<std::string> str_atoms_;
+  const std::set<std::string> str_equalities_;
+  const std::unordered_map<std::string, size_t> idx_str_atoms_;
+
   const std::set<std::string> initial_state_;
 
   mutable FormulaMap formulas_;
+  mutable std::map<std::pair<const VAL::operator_*, std::vector<const VAL::parameter_symbol*>>,
+                   GroundAction> ground_actions_;
 
 };
 
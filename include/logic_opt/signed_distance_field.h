@@ -0,0 +1,92 @@
+/**
+ * signed_distance_field.h
+ *
+ * Copyright 2026. All Rights Reserved.
+ *
+ * Created: October 17, 2026
+ * Authors: Toki Migimatsu
+ */
+
+#ifndef LOGIC_OPT_SIGNED_DISTANCE_FIELD_H_
+#define LOGIC_OPT_SIGNED_DISTANCE_FIELD_H_
+
+#include <spatial_dyn/spatial_dyn.h>
+
+#include <cstdint>  // uint64_t
+#include <memory>   // std::shared_ptr, std::unique_ptr
+#include <string>   // std::string
+#include <vector>   // std::vector
+
+#include <ncollide_cpp/ncollide.h>
+
+namespace logic_opt {
+
+/**
+ * Signed distance to a shape sampled on a voxel grid in the shape's frame.
+ *
+ * Distances are positive outside the shape and negative inside, and are
+ * interpolated trilinearly between grid points. The grid covers the bounding
+ * box of the shape padded by a margin. Queries outside the grid add the
+ * distance to the grid boundary.
+ */
+class SignedDistanceField {
+
+ public:
+
+  static constexpr double kDefaultResolution = 0.01;
+  static constexpr double kDefaultMargin = 0.1;
+
+  SignedDistanceField(const ncollide3d::shape::Shape& shape,
+                      double resolution = kDefaultResolution, double margin = kDefaultMargin);
+
+  /**
+   * Load the field of the object with the given graphics from the cache
+   * directory, or compute it from the collision shape and save it there if it
+   * isn't cached yet. Cache entries are keyed by a hash of the geometry,
+   * including the contents of mesh files, and the grid parameters.
+   */
+  static std::shared_ptr<const SignedDistanceField>
+  LoadOrCompute(const std::vector<spatial_dyn::Graphics>& graphics,
+                const ncollide3d::shape::Shape& shape, const std::string& cache_dir,
+                double resolution = kDefaultResolution, double margin = kDefaultMargin);
+
+  /**
+   * Load the field from a file. Returns nullptr if the file doesn't exist or
+   * doesn't match the key.
+   */
+  static std::unique_ptr<SignedDistanceField> Load(const std::string& filename, uint64_t key);
+
+  /**
+   * Save the field to a file. Failures are reported on stderr but not
+   * thrown, since the cache is optional.
+   */
+  void Save(const std::string& filename, uint64_t key) const;
+
+  /**
+   * Signed distance from the point, given in the shape's frame. If gradient
+   * isn't null, it is set to the spatial gradient of the distance.
+   */
+  double Distance(const Eigen::Vector3d& point, Eigen::Vector3d* gradient = nullptr) const;
+
+  double resolution() const { return resolution_; }
+
+  const Eigen::Vector3d& origin() const { return origin_; }
+
+  const Eigen::Array3i& size() const { return size_; }
+
+ private:
+
+  SignedDistanceField() {}
+
+  size_t Index(int x, int y, int z) const { return x + size_(0) * (y + size_(1) * z); }
+
+  double resolution_ = kDefaultResolution;
+  Eigen::Vector3d origin_ = Eigen::Vector3d::Zero();  // Position of grid point (0, 0, 0)
+  Eigen::Array3i size_ = Eigen::Array3i::Zero();      // Number of grid points along each axis
+  std::vector<float> values_;
+
+};
+
+}  // namespace logic_opt
+
+#endif  // LOGIC_OPT_SIGNED_DISTANCE_FIELD_H_
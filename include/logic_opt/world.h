@@ -12,17 +12,25 @@
 
 #include <spatial_dyn/spatial_dyn.h>
 
-#include <algorithm>    // std::max
-#include <exception>    // std::out_of_range
-#include <map>          // std::map
-#include <memory>       // std::unique_ptr, std::shared_ptr
-#include <string>       // std::string
-#include <type_traits>  // std::conditional_t
-
-#include <ctrl_utils/tree.h>
+#include <algorithm>      // std::max
+#include <atomic>         // std::atomic
+#include <cmath>          // std::cos, std::sin, std::sqrt
+#include <exception>      // std::out_of_range
+#include <map>            // std::map
+#include <iterator>       // std::next
+#include <memory>         // std::unique_ptr, std::shared_ptr
+#include <mutex>          // std::mutex, std::lock_guard
+#include <optional>       // std::optional
+#include <string>         // std::string
+#include <thread>         // std::thread
+#include <type_traits>    // std::conditional_t, std::enable_if_t, std::is_same
+#include <unordered_map>  // std::unordered_map
+#include <vector>         // std::vector
+
 #include <ncollide_cpp/ncollide.h>
 
 #include "logic_opt/optimization/variables.h"
+#include "logic_opt/signed_distance_field.h"
 
 namespace logic_opt {
 
@@ -59,9 +67,149 @@ class Frame {
 
 };
 
+/**
+ * Dense frame ids shared by all timesteps and copies of a world. The world
+ * frame is id 0, followed by the objects in name order.
+ */
+struct FrameIndex {
+
+  std::vector<std::string> names;
+  std::unordered_map<std::string, size_t> ids;
+
+};
+
+/**
+ * Kinematic tree at one timestep, stored as flat arrays indexed by frame id.
+ * Timesteps with the same topology share one instance.
+ */
+struct FrameTopology {
+
+  bool operator==(const FrameTopology& other) const {
+    return parents == other.parents && idx_vars == other.idx_vars;
+  }
+
+  std::vector<int> parents;   // -1 for the world frame
+  std::vector<int> idx_vars;  // -1 for constant frames
+
+};
+
+/**
+ * Read-only view of the kinematic tree at one timestep.
+ */
+class FrameTree {
+
+ public:
+
+  static constexpr int kNoParent = -1;
+
+  FrameTree(const std::shared_ptr<const FrameIndex>& index,
+            const std::shared_ptr<const FrameTopology>& topology)
+      : index_(index), topology_(topology) {}
+
+  size_t size() const { return index_->names.size(); }
+
+  bool contains(const std::string& name) const {
+    return index_->ids.find(name) != index_->ids.end();
+  }
+
+  size_t id(const std::string& name) const;
+
+  const std::string& name(size_t id) const { return index_->names[id]; }
+
+  Frame at(const std::string& name) const { return frame(id(name)); }
+
+  Frame frame(size_t id) const { return Frame(index_->names[id], topology_->idx_vars[id]); }
+
+  int parent(size_t id) const { return topology_->parents[id]; }
+
+  int idx_var(size_t id) const { return topology_->idx_vars[id]; }
+
+  std::optional<std::string> parent(const std::string& name) const;
+
+  /**
+   * Frames in id order.
+   */
+  std::vector<std::pair<std::string, Frame>> values() const;
+
+  /**
+   * Frames from the given one up to the root, inclusive.
+   */
+  std::vector<std::pair<const std::string, Frame>> ancestors(const std::string& name) const;
+
+  /**
+   * Frames in the subtree rooted at the given one, inclusive.
+   */
+  std::vector<std::pair<const std::string, Frame>> descendants(const std::string& name) const;
+
+  /**
+   * Frames count as their own ancestors and descendants.
+   */
+  bool is_ancestor(size_t id_ancestor, size_t id_descendant) const;
+
+  bool is_ancestor(const std::string& ancestor, const std::string& descendant) const {
+    return is_ancestor(id(ancestor), id(descendant));
+  }
+
+  bool is_descendant(const std::string& descendant, const std::string& ancestor) const {
+    return is_ancestor(id(ancestor), id(descendant));
+  }
+
+ private:
+
+  std::shared_ptr<const FrameIndex> index_;
+  std::shared_ptr<const FrameTopology> topology_;
+
+};
+
 template<int Dim>
 Eigen::Transform<double, Dim, Eigen::Isometry> ConvertIsometry(const Eigen::Isometry3d& T);
 
+/**
+ * Rotation matrix of the exponential coordinates w, generic over the scalar
+ * type. Near w = 0 the coefficients are replaced by their Taylor expansions so
+ * that derivatives with respect to w stay finite.
+ */
+template<typename Scalar>
+Eigen::Matrix<Scalar, 3, 3> ExpMapRotation(const Eigen::Matrix<Scalar, 3, 1>& w) {
+  using std::cos;
+  using std::sin;
+  using std::sqrt;
+
+  const Scalar theta_sq = w.squaredNorm();
+  Scalar a;  // sin(theta) / theta
+  Scalar b;  // (1 - cos(theta)) / theta^2
+  if (theta_sq < 1e-8) {
+    a = 1. - theta_sq / 6.;
+    b = 0.5 - theta_sq / 24.;
+  } else {
+    const Scalar theta = sqrt(theta_sq);
+    a = sin(theta) / theta;
+    b = (1. - cos(theta)) / theta_sq;
+  }
+
+  Eigen::Matrix<Scalar, 3, 3> w_cross;
+  w_cross << Scalar(0.), -w(2), w(1),
+             w(2), Scalar(0.), -w(0),
+             -w(1), w(0), Scalar(0.);
+  return Eigen::Matrix<Scalar, 3, 3>::Identity() + a * w_cross + b * w_cross * w_cross;
+}
+
+/**
+ * Planar rotation matrix of the angle theta, generic over the scalar type.
+ */
+template<typename Scalar>
+Eigen::Matrix<Scalar, 2, 2> ExpMapRotation(const Eigen::Matrix<Scalar, 1, 1>& theta) {
+  using std::cos;
+  using std::sin;
+
+  const Scalar cos_theta = cos(theta(0));
+  const Scalar sin_theta = sin(theta(0));
+  Eigen::Matrix<Scalar, 2, 2> R;
+  R << cos_theta, -sin_theta,
+       sin_theta, cos_theta;
+  return R;
+}
+
 template<int Dim>
 class Object : public spatial_dyn::RigidBody {
 
@@ -75,6 +223,17 @@ class Object : public spatial_dyn::RigidBody {
 
   std::shared_ptr<typename ncollide<Dim>::shape::Shape> collision;
 
+  // Optional precomputed distance field of the 3d collision shape
+  std::shared_ptr<const SignedDistanceField> sdf;
+
+  /**
+   * Replace the triangle meshes in the collision shape with convex
+   * decompositions, which are faster to query but only approximate the mesh.
+   * Meshes that can't be decomposed keep their triangle mesh. Only
+   * implemented for 3d objects.
+   */
+  void DecomposeMeshes(double max_concavity, size_t max_parts);
+
   template<int Dim_ = Dim>
   const typename std::enable_if_t<Dim_ == 2, Eigen::Isometry2d>&
   T_to_parent() const { return T_to_parent_2d_; }
@@ -106,6 +265,16 @@ class World {
   using Isometry = Eigen::Transform<double, Dim, Eigen::Isometry>;
   using Rotation = std::conditional_t<Dim == 2, Eigen::Rotation2Dd, Eigen::AngleAxisd>;
 
+  template<typename Scalar>
+  using IsometryT = Eigen::Transform<Scalar, Dim, Eigen::Isometry>;
+
+  template<typename Scalar>
+  using MatrixT = Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>;
+
+  // Selects the scalar-generic overloads only for non-double scalars
+  template<typename Scalar>
+  using EnableIfScalar = std::enable_if_t<!std::is_same<Scalar, double>::value>;
+
   World(const std::shared_ptr<const std::map<std::string, Object<Dim>>>& objects,
         size_t T = 1);
 
@@ -124,7 +293,11 @@ class World {
 
   void DetachFrame(const std::string& name_frame, size_t t);
 
-  const ctrl_utils::Tree<std::string, Frame>& frames(size_t t) const { return frames_[t]; }
+  FrameTree frames(size_t t) const { return FrameTree(frame_index_, topologies_.at(t)); }
+
+  size_t num_frames() const { return frame_index_->names.size(); }
+
+  size_t FrameId(const std::string& name_frame) const;
 
   void set_controller_frames(const std::string& control_frame,
                              const std::string& target_frame, size_t t);
@@ -182,16 +355,188 @@ class World {
                                               Eigen::Ref<const Eigen::MatrixXd> X,
                                               size_t t) const;
 
+  /**
+   * Scalar-generic transforms for forward-mode automatic differentiation, for
+   * example with X of type MatrixT<Eigen::AutoDiffScalar<Eigen::VectorXd>>.
+   *
+   * These walk the frame chain directly instead of going through the
+   * kinematics cache, so their cost is the chain length times the cost of the
+   * scalar operations.
+   */
+  template<typename Scalar, typename = EnableIfScalar<Scalar>>
+  IsometryT<Scalar> T_to_world(const std::string& name_frame, const MatrixT<Scalar>& X,
+                               size_t t) const;
+
+  template<typename Scalar, typename = EnableIfScalar<Scalar>>
+  IsometryT<Scalar> T_to_frame(const std::string& from_frame, const std::string& to_frame,
+                               const MatrixT<Scalar>& X, size_t t) const;
+
+  template<typename Scalar, typename = EnableIfScalar<Scalar>>
+  IsometryT<Scalar> T_control_to_target(const MatrixT<Scalar>& X, size_t t) const;
+
+  template<typename Scalar, typename = EnableIfScalar<Scalar>>
+  Eigen::Matrix<Scalar, Dim, 1> Position(const std::string& of_frame, const std::string& in_frame,
+                                         const MatrixT<Scalar>& X, size_t t) const;
+
+  template<typename Scalar, typename = EnableIfScalar<Scalar>>
+  Eigen::Matrix<Scalar, Dim, Dim> Orientation(const std::string& of_frame,
+                                              const std::string& in_frame,
+                                              const MatrixT<Scalar>& X, size_t t) const;
+
  protected:
 
+  /**
+   * Frame-to-world transforms for the most recently queried configuration.
+   *
+   * The cache is stamped with a version that is incremented whenever a query
+   * arrives with a different X, so every objective and constraint evaluated at
+   * the same Ipopt iterate shares the same transforms. Entries are filled
+   * lazily from the root down and stamped individually, so a finite
+   * difference query with a perturbed X only recomputes the chains it touches.
+   */
+  struct KinematicsCache {
+
+    void Clear() { versions.clear(); }
+
+    Eigen::MatrixXd X;          // Configuration of the cached transforms
+    size_t version = 0;         // Incremented whenever X changes
+    size_t generation = 0;      // Kinematic tree generation of the cached transforms
+
+    // Indexed by t * num_frames + id_frame
+    std::vector<size_t> versions;
+    std::vector<Isometry, Eigen::aligned_allocator<Isometry>> T_to_world;
+
+  };
+
+  /**
+   * One kinematics cache per querying thread, so that constraints evaluated
+   * in parallel neither contend on nor evict each other's transforms. Copies
+   * start out empty since their kinematic trees may diverge.
+   *
+   * Threads only ever touch their own cache. Clear() bumps a generation
+   * counter that each thread checks on access, and caches of threads that
+   * have exited are dropped whenever a new thread registers.
+   */
+  class ThreadKinematicsCaches {
+
+   public:
+
+    ThreadKinematicsCaches() : id_(NextId()) {}
+    ThreadKinematicsCaches(const ThreadKinematicsCaches&) : id_(NextId()) {}
+    ThreadKinematicsCaches& operator=(const ThreadKinematicsCaches&) { Clear(); return *this; }
+
+    KinematicsCache& local() {
+      // Threads usually keep querying the same world, so remember the last
+      // lookup and only take the lock when switching worlds. Ids are never
+      // reused, so a destroyed world can't be mistaken for a new one.
+      thread_local size_t id_last = 0;
+      thread_local KinematicsCache* cache_last = nullptr;
+      if (id_last != id_) {
+        cache_last = Register();
+        id_last = id_;
+      }
+
+      const size_t generation = generation_.load(std::memory_order_acquire);
+      if (cache_last->generation != generation) {
+        cache_last->Clear();
+        cache_last->generation = generation;
+      }
+      return *cache_last;
+    }
+
+    void Clear() { generation_.fetch_add(1, std::memory_order_release); }
+
+    /**
+     * Drop the caches of threads that have exited.
+     */
+    void Prune() {
+      std::lock_guard<std::mutex> lock(mtx_);
+      PruneLocked();
+    }
+
+   private:
+
+    /**
+     * Flag that is cleared when the owning thread exits.
+     */
+    struct ThreadAlive {
+      ThreadAlive() : is_alive(std::make_shared<std::atomic<bool>>(true)) {}
+      ~ThreadAlive() { is_alive->store(false, std::memory_order_release); }
+      std::shared_ptr<std::atomic<bool>> is_alive;
+    };
+
+    struct Entry {
+      std::shared_ptr<const std::atomic<bool>> is_thread_alive;
+      KinematicsCache cache;
+    };
+
+    static size_t NextId() {
+      static std::atomic<size_t> id(1);
+      return id++;
+    }
+
+    KinematicsCache* Register() {
+      thread_local const ThreadAlive thread_alive;
+      std::lock_guard<std::mutex> lock(mtx_);
+      PruneLocked();
+      Entry& entry = caches_[std::this_thread::get_id()];
+      entry.is_thread_alive = thread_alive.is_alive;
+      return &entry.cache;
+    }
+
+    void PruneLocked() {
+      for (auto it = caches_.begin(); it != caches_.end(); ) {
+        const bool is_alive = it->second.is_thread_alive->load(std::memory_order_acquire);
+        it = is_alive ? std::next(it) : caches_.erase(it);
+      }
+    }
+
+    const size_t id_;
+    std::atomic<size_t> generation_{0};
+    std::mutex mtx_;
+    std::map<std::thread::id, Entry> caches_;  // Nodes are never moved
+
+  };
+
+  /**
+   * Apply the update to copies of the topologies in [t_start, t_end).
+   * Timesteps that shared a topology before the update share it afterwards.
+   */
+  template<typename UpdateT>
+  void UpdateTopology(size_t t_start, size_t t_end, const UpdateT& update);
+
+  /**
+   * Get the calling thread's cache, resized if necessary and stamped with a
+   * new version if X changed.
+   */
+  KinematicsCache& UpdateKinematics(Eigen::Ref<const Eigen::MatrixXd> X) const;
+
+  const Isometry& CachedT_to_world(KinematicsCache& cache, size_t id_frame, size_t t) const;
+
+  /**
+   * Same as frames(t).is_ancestor() without constructing a FrameTree.
+   */
+  bool IsAncestor(size_t id_ancestor, size_t id_descendant, size_t t) const;
+
+  /**
+   * Uncached frame-to-world transform for scalar-generic X.
+   */
+  template<typename Scalar>
+  IsometryT<Scalar> ComputeT_to_world(size_t id_frame, const MatrixT<Scalar>& X, size_t t) const;
+
   const std::shared_ptr<const std::map<std::string, Object<Dim>>> objects_;
 
-  std::vector<ctrl_utils::Tree<std::string, Frame>> frames_;
+  std::shared_ptr<const FrameIndex> frame_index_;
+  std::vector<const Object<Dim>*> frame_objects_;  // nullptr for the world frame
+
+  std::vector<std::shared_ptr<const FrameTopology>> topologies_;
 
   std::vector<std::pair<std::string, std::string>> controller_frames_;
 
   std::vector<std::string> controllers_;
 
+  mutable ThreadKinematicsCaches kinematics_;
+
   static Rotation ExtractRotation(Eigen::Ref<const Eigen::MatrixXd> X, size_t t);
 
 };
@@ -234,37 +579,45 @@ template<int Dim>
 World<Dim>::World(const std::shared_ptr<const std::map<std::string, Object<Dim>>>& objects,
                   size_t T)
     : objects_(objects),
-      frames_(std::max(T, static_cast<size_t>(1))),
       controller_frames_(std::max(T, static_cast<size_t>(1)), {"", ""}),
       controllers_(std::max(T, static_cast<size_t>(1))) {
 
-  for (ctrl_utils::Tree<std::string, Frame>& frames_t : frames_) {
-    frames_t.insert(kWorldFrame, Frame(kWorldFrame));
-  }
+  auto frame_index = std::make_shared<FrameIndex>();
+  frame_index->ids[kWorldFrame] = 0;
+  frame_index->names.push_back(kWorldFrame);
+  frame_objects_.push_back(nullptr);
 
   for (const auto& key_val : *objects_) {
     const std::string& name = key_val.first;
-
-    for (ctrl_utils::Tree<std::string, Frame>& frames_t : frames_) {
-      frames_t.insert_child(kWorldFrame, name, Frame(name));
-    }
+    frame_index->ids[name] = frame_index->names.size();
+    frame_index->names.push_back(name);
+    frame_objects_.push_back(&key_val.second);
   }
+  frame_index_ = std::move(frame_index);
+
+  // All timesteps start out with the objects attached to the world
+  auto topology = std::make_shared<FrameTopology>();
+  topology->parents.assign(frame_objects_.size(), 0);
+  topology->parents[0] = FrameTree::kNoParent;
+  topology->idx_vars.assign(frame_objects_.size(), -1);
+  topologies_.assign(controller_frames_.size(), std::move(topology));
 }
 
 template<int Dim>
 void World<Dim>::ReserveTimesteps(size_t T) {
-  if (frames_.size() >= T) return;
-  frames_.reserve(T);
+  if (topologies_.size() >= T) return;
+  topologies_.reserve(T);
   controller_frames_.reserve(T);
   controllers_.reserve(T);
 
-  for (size_t t = frames_.size(); t < T; t++) {
-    // Copy kinematic tree from previous timestep
-    frames_.push_back(frames_.back());
+  for (size_t t = topologies_.size(); t < T; t++) {
+    // Share kinematic tree with previous timestep
+    topologies_.push_back(topologies_.back());
 
     controller_frames_.push_back({"", ""});
     controllers_.push_back("");
   }
+  kinematics_.Clear();
 }
 
 template<int Dim>
@@ -273,37 +626,43 @@ void World<Dim>::AttachFrame(const std::string& name_frame, const std::string& n
   if (name_frame == name_target) {
     throw std::runtime_error("World::AttachFrame(): Cannot attach frame " + name_frame + " to itself.");
   }
+  const size_t id_frame = FrameId(name_frame);
+  const int id_target = FrameId(name_target);
   if (fixed) {
-    for (size_t tt = t; tt < frames_.size(); tt++) {
-      frames_[tt].set_parent(name_frame, name_target);
-    }
+    UpdateTopology(t, topologies_.size(), [id_frame, id_target](FrameTopology& topology) {
+      topology.parents[id_frame] = id_target;
+    });
     return;
   }
   // Set frames for all empty preceding timesteps
   for (int tt = t; tt >= 0; tt--) {
     // Check if frame is being controlled
-    // if (!control_frame(tt).empty() && frames_[tt].at(control_frame(tt)).idx_var() == tt) break;
     if (!control_frame(tt).empty()) break;
 
     // Set control variable to current timestep
-    frames_[tt].set_parent(name_frame, name_target);
+    UpdateTopology(tt, tt + 1, [id_frame, id_target, tt](FrameTopology& topology) {
+      topology.parents[id_frame] = id_target;
+      topology.idx_vars[id_frame] = tt;
+    });
     set_controller_frames(name_frame, name_target, tt);
-    frames_[tt].at(name_frame).set_idx_var(tt);
   }
 
   // Update frame tree for all subsequent timesteps
-  for (size_t tt = t + 1; tt < frames_.size(); tt++) {
-    frames_[tt].set_parent(name_frame, name_target);
+  UpdateTopology(t + 1, topologies_.size(), [id_frame, id_target, t](FrameTopology& topology) {
+    topology.parents[id_frame] = id_target;
+    topology.idx_vars[id_frame] = t;
+  });
+  for (size_t tt = t + 1; tt < topologies_.size(); tt++) {
     set_controller_frames("", "", tt);
-    frames_[tt].at(name_frame).set_idx_var(t);
   }
 }
 
 template<int Dim>
 void World<Dim>::DetachFrame(const std::string& name_frame, size_t t) {
-  for (size_t tt = t; tt < frames_.size(); tt++) {
-    frames_[tt].set_parent(name_frame, kWorldFrame);
-  }
+  const size_t id_frame = FrameId(name_frame);
+  UpdateTopology(t, topologies_.size(), [id_frame](FrameTopology& topology) {
+    topology.parents[id_frame] = 0;
+  });
 }
 
 template<int Dim>
@@ -313,20 +672,42 @@ void World<Dim>::set_controller_frames(const std::string& control_frame, const s
   controller_frames_[t].second = target_frame;
 }
 
+template<int Dim>
+size_t World<Dim>::FrameId(const std::string& name_frame) const {
+  auto it = frame_index_->ids.find(name_frame);
+  if (it == frame_index_->ids.end()) {
+    throw std::out_of_range("World::FrameId(): frame \"" + name_frame + "\" does not exist.");
+  }
+  return it->second;
+}
+
+template<int Dim>
+bool World<Dim>::IsAncestor(size_t id_ancestor, size_t id_descendant, size_t t) const {
+  const std::vector<int>& parents = topologies_.at(t)->parents;
+  for (int i = id_descendant; i != FrameTree::kNoParent; i = parents[i]) {
+    if (i == static_cast<int>(id_ancestor)) return true;
+  }
+  return false;
+}
+
 template<int Dim>
 typename World<Dim>::Isometry World<Dim>::T_to_world(const std::string& name_frame,
                                                      Eigen::Ref<const Eigen::MatrixXd> X,
                                                      size_t t) const {
-  return T_to_frame(name_frame, kWorldFrame, X, t);
+  const size_t id_frame = FrameId(name_frame);
+  KinematicsCache& cache = UpdateKinematics(X);
+  return CachedT_to_world(cache, id_frame, t);
 }
 
 template<int Dim>
 typename World<Dim>::Isometry World<Dim>::T_to_parent(const std::string& name_frame,
                                                       Eigen::Ref<const Eigen::MatrixXd> X,
                                                       size_t t) const {
-  const Frame& frame = frames_[t].at(name_frame);
-  return frame.is_variable() ? T_control_to_target(X, frame.idx_var())
-                             : objects_->at(frame.name()).T_to_parent();
+  const size_t id_frame = FrameId(name_frame);
+  const int idx_var = topologies_.at(t)->idx_vars[id_frame];
+  if (idx_var >= 0) return T_control_to_target(X, idx_var);
+  if (id_frame == 0) return Isometry::Identity();
+  return frame_objects_[id_frame]->template T_to_parent<Dim>();
 }
 
 template<int Dim>
@@ -334,29 +715,10 @@ typename World<Dim>::Isometry World<Dim>::T_to_frame(const std::string& from_fra
                                                      const std::string& to_frame,
                                                      Eigen::Ref<const Eigen::MatrixXd> X,
                                                      size_t t) const {
-  std::string ancestor_frame;
-  std::string descendant_frame;
-  Isometry T_result = Isometry::Identity();
-  if (frames_[t].is_ancestor(to_frame, from_frame)) {
-    ancestor_frame = to_frame;
-    descendant_frame = from_frame;
-  } else if (frames_[t].is_ancestor(from_frame, to_frame)) {
-    ancestor_frame = from_frame;
-    descendant_frame = to_frame;
-  } else {
-    T_result = T_to_world(to_frame, X, t).inverse() * T_to_world(from_frame, X, t);
-    return T_result;
-  }
-
-  for (const std::pair<std::string, Frame>& key_val : frames_[t].ancestors(descendant_frame)) {
-    const std::string& frame = key_val.first;
-    if (frame == ancestor_frame) break;
-    T_result = T_to_parent(frame, X, t) * T_result;
-  }
-  if (ancestor_frame == from_frame) {
-    T_result = T_result.inverse();
-  }
-  return T_result;
+  const size_t id_from = FrameId(from_frame);
+  const size_t id_to = FrameId(to_frame);
+  KinematicsCache& cache = UpdateKinematics(X);
+  return CachedT_to_world(cache, id_to, t).inverse() * CachedT_to_world(cache, id_from, t);
 }
 
 template<int Dim>
@@ -371,52 +733,194 @@ Eigen::Matrix<double, Dim, 1> World<Dim>::Position(const std::string& of_frame,
                                                    const std::string& in_frame,
                                                    Eigen::Ref<const Eigen::MatrixXd> X,
                                                    size_t t) const {
+  const size_t id_of = FrameId(of_frame);
+  const size_t id_in = FrameId(in_frame);
+  if (!IsAncestor(id_in, id_of, t)) {
+    throw std::invalid_argument("World::Position(): frame \"" + of_frame +
+                                "\" must be an descendant of \"" + in_frame + "\"");
+  }
 
-  Eigen::Matrix<double, Dim, 1> p = Eigen::Matrix<double, Dim, 1>::Zero();
-  bool frame_reached = false;
-  for (const std::pair<std::string, Frame>& key_val : frames_[t].ancestors(of_frame)) {
-    if (key_val.first == in_frame) {
-      frame_reached = true;
-      break;
-    }
+  KinematicsCache& cache = UpdateKinematics(X);
+  const Isometry& T_in_to_world = CachedT_to_world(cache, id_in, t);
+  const Isometry& T_of_to_world = CachedT_to_world(cache, id_of, t);
+  return T_in_to_world.linear().transpose() *
+         (T_of_to_world.translation() - T_in_to_world.translation());
+}
 
-    const Frame& frame = key_val.second;
-    p = T_to_parent(frame.name(), X, t) * p;
+template<int Dim>
+Eigen::Matrix<double, Dim, Dim> World<Dim>::Orientation(const std::string& of_frame,
+                                                        const std::string& in_frame,
+                                                        Eigen::Ref<const Eigen::MatrixXd> X,
+                                                        size_t t) const {
+  const size_t id_of = FrameId(of_frame);
+  const size_t id_in = FrameId(in_frame);
+  if (!IsAncestor(id_in, id_of, t)) {
+    throw std::invalid_argument("World::Orientation(): frame \"" + of_frame +
+                                "\" must be an descendant of \"" + in_frame + "\"");
   }
 
-  if (!frame_reached) {
+  KinematicsCache& cache = UpdateKinematics(X);
+  return CachedT_to_world(cache, id_in, t).linear().transpose() *
+         CachedT_to_world(cache, id_of, t).linear();
+}
+
+template<int Dim>
+template<typename Scalar, typename>
+typename World<Dim>::template IsometryT<Scalar>
+World<Dim>::T_to_world(const std::string& name_frame, const MatrixT<Scalar>& X, size_t t) const {
+  return ComputeT_to_world(FrameId(name_frame), X, t);
+}
+
+template<int Dim>
+template<typename Scalar, typename>
+typename World<Dim>::template IsometryT<Scalar>
+World<Dim>::T_to_frame(const std::string& from_frame, const std::string& to_frame,
+                       const MatrixT<Scalar>& X, size_t t) const {
+  return ComputeT_to_world(FrameId(to_frame), X, t).inverse() *
+         ComputeT_to_world(FrameId(from_frame), X, t);
+}
+
+template<int Dim>
+template<typename Scalar, typename>
+typename World<Dim>::template IsometryT<Scalar>
+World<Dim>::T_control_to_target(const MatrixT<Scalar>& X, size_t t) const {
+  IsometryT<Scalar> T = IsometryT<Scalar>::Identity();
+  T.translation() = X.template block<Dim, 1>(0, t);
+  T.linear() = ExpMapRotation<Scalar>(Eigen::Matrix<Scalar, kDof - Dim, 1>(X.template block<kDof - Dim, 1>(Dim, t)));
+  return T;
+}
+
+template<int Dim>
+template<typename Scalar, typename>
+Eigen::Matrix<Scalar, Dim, 1> World<Dim>::Position(const std::string& of_frame,
+                                                   const std::string& in_frame,
+                                                   const MatrixT<Scalar>& X, size_t t) const {
+  const size_t id_of = FrameId(of_frame);
+  const size_t id_in = FrameId(in_frame);
+  if (!IsAncestor(id_in, id_of, t)) {
     throw std::invalid_argument("World::Position(): frame \"" + of_frame +
                                 "\" must be an descendant of \"" + in_frame + "\"");
   }
-  return p;
+
+  const IsometryT<Scalar> T_in_to_world = ComputeT_to_world(id_in, X, t);
+  const IsometryT<Scalar> T_of_to_world = ComputeT_to_world(id_of, X, t);
+  return T_in_to_world.linear().transpose() *
+         (T_of_to_world.translation() - T_in_to_world.translation());
 }
 
 template<int Dim>
-Eigen::Matrix<double, Dim, Dim> World<Dim>::Orientation(const std::string& of_frame,
+template<typename Scalar, typename>
+Eigen::Matrix<Scalar, Dim, Dim> World<Dim>::Orientation(const std::string& of_frame,
                                                         const std::string& in_frame,
-                                                        Eigen::Ref<const Eigen::MatrixXd> X,
+                                                        const MatrixT<Scalar>& X,
                                                         size_t t) const {
-  Eigen::Matrix<double, Dim, Dim> R = Eigen::Matrix<double, Dim, Dim>::Identity();
-  bool frame_reached = false;
-  for (const std::pair<std::string, Frame>& key_val : frames_[t].ancestors(of_frame)) {
-    if (key_val.first == in_frame) {
-      frame_reached = true;
-      break;
+  const size_t id_of = FrameId(of_frame);
+  const size_t id_in = FrameId(in_frame);
+  if (!IsAncestor(id_in, id_of, t)) {
+    throw std::invalid_argument("World::Orientation(): frame \"" + of_frame +
+                                "\" must be an descendant of \"" + in_frame + "\"");
+  }
+
+  return ComputeT_to_world(id_in, X, t).linear().transpose() *
+         ComputeT_to_world(id_of, X, t).linear();
+}
+
+template<int Dim>
+template<typename Scalar>
+typename World<Dim>::template IsometryT<Scalar>
+World<Dim>::ComputeT_to_world(size_t id_frame, const MatrixT<Scalar>& X, size_t t) const {
+  if (t >= topologies_.size()) {
+    throw std::out_of_range("World::T_to_world(): t (" + std::to_string(t) +
+                            ") must be less than " + std::to_string(topologies_.size()));
+  }
+
+  // Accumulate transforms from the frame up to the root
+  const FrameTopology& topology = *topologies_[t];
+  IsometryT<Scalar> T_to_world = IsometryT<Scalar>::Identity();
+  for (int id = id_frame; topology.parents[id] != FrameTree::kNoParent; id = topology.parents[id]) {
+    const int idx_var = topology.idx_vars[id];
+    if (idx_var >= 0) {
+      T_to_world = T_control_to_target(X, idx_var) * T_to_world;
+    } else {
+      T_to_world = frame_objects_[id]->template T_to_parent<Dim>().template cast<Scalar>() *
+                   T_to_world;
     }
+  }
+  return T_to_world;
+}
 
-    const Frame& frame = key_val.second;
-    if (frame.is_variable()) {
-      R = ExtractRotation(X, frame.idx_var()) * R;
+template<int Dim>
+template<typename UpdateT>
+void World<Dim>::UpdateTopology(size_t t_start, size_t t_end, const UpdateT& update) {
+  kinematics_.Clear();
+
+  std::shared_ptr<const FrameTopology> old_prev;
+  std::shared_ptr<const FrameTopology> new_prev;
+  for (size_t t = t_start; t < t_end; t++) {
+    const std::shared_ptr<const FrameTopology> old_t = topologies_[t];
+    if (old_t == old_prev) {
+      topologies_[t] = new_prev;
+      continue;
+    }
+
+    auto new_t = std::make_shared<FrameTopology>(*old_t);
+    update(*new_t);
+    old_prev = old_t;
+    if (*new_t == *old_t) {
+      new_prev = old_t;
+    } else if (t > 0 && *new_t == *topologies_[t - 1]) {
+      // Merge with the previous timestep if the update made them identical
+      new_prev = topologies_[t - 1];
     } else {
-      R = objects_->at(frame.name()).T_to_parent().linear() * R;
+      new_prev = std::move(new_t);
     }
+    topologies_[t] = new_prev;
   }
+}
 
-  if (!frame_reached) {
-    throw std::invalid_argument("World::Orientation(): frame \"" + of_frame +
-                                "\" must be an descendant of \"" + in_frame + "\"");
+template<int Dim>
+typename World<Dim>::KinematicsCache&
+World<Dim>::UpdateKinematics(Eigen::Ref<const Eigen::MatrixXd> X) const {
+  KinematicsCache& cache = kinematics_.local();
+
+  // Reallocate after the kinematic trees are modified
+  if (cache.versions.empty()) {
+    const size_t num_entries = topologies_.size() * frame_objects_.size();
+    cache.versions.assign(num_entries, 0);
+    cache.T_to_world.resize(num_entries);
+    cache.X.resize(0, 0);
   }
-  return R;
+
+  if (cache.X.rows() == X.rows() && cache.X.cols() == X.cols() && cache.X == X) return cache;
+  cache.X = X;
+  cache.version++;
+  return cache;
+}
+
+template<int Dim>
+const typename World<Dim>::Isometry& World<Dim>::CachedT_to_world(KinematicsCache& cache,
+                                                                  size_t id_frame,
+                                                                  size_t t) const {
+  if (t >= topologies_.size()) {
+    throw std::out_of_range("World::T_to_world(): t (" + std::to_string(t) +
+                            ") must be less than " + std::to_string(topologies_.size()));
+  }
+  const size_t idx = t * frame_objects_.size() + id_frame;
+  Isometry& T_to_world = cache.T_to_world[idx];
+  if (cache.versions[idx] == cache.version) return T_to_world;
+
+  const FrameTopology& topology = *topologies_[t];
+  const int id_parent = topology.parents[id_frame];
+  if (id_parent == FrameTree::kNoParent) {
+    T_to_world = Isometry::Identity();
+  } else {
+    const int idx_var = topology.idx_vars[id_frame];
+    const Isometry T_to_parent = idx_var >= 0 ? T_control_to_target(cache.X, idx_var)
+                                              : frame_objects_[id_frame]->template T_to_parent<Dim>();
+    T_to_world = CachedT_to_world(cache, id_parent, t) * T_to_parent;
+  }
+  cache.versions[idx] = cache.version;
+  return T_to_world;
 }
 
 template<int Dim>
@@ -9,19 +9,16 @@
 
 #include "logic_opt/constraints/collision_constraint.h"
 
-#include <algorithm>  // std::find, std::iter_swap, std::max, std::min
+#include <algorithm>  // std::max, std::min, std::sort
+#include <cmath>      // std::abs
 #include <exception>  // std::runtime_error
 #include <limits>     // std::numeric_limits
-#include <sstream>    // std::stringstream
 #include <utility>    // std::move
 
 #include <ctrl_utils/math.h>
 
 namespace {
 
-const double kH = 1e-5;
-const double kH_ori = 1e-2;
-
 const double kMaxDist = 0.1;
 
 std::string ControlFrame(const logic_opt::World3& world, size_t t) {
@@ -38,6 +35,33 @@ std::string TargetFrame(const logic_opt::World3& world, size_t t) {
   throw std::runtime_error("CollisionConstraint::TargetFrame(): No target frame found.");
 }
 
+Eigen::Matrix3Xd CollisionPoints(const ncollide3d::shape::Shape& shape) {
+  // Collect the vertices of compound shape components in the compound frame
+  const auto compound = dynamic_cast<const ncollide3d::shape::Compound*>(&shape);
+  if (compound == nullptr) {
+    const ncollide3d::shape::TriMesh trimesh = shape.to_trimesh();
+    Eigen::Matrix3Xd points(3, trimesh.num_points());
+    for (size_t i = 0; i < trimesh.num_points(); i++) {
+      points.col(i) = trimesh.point(i);
+    }
+    return points;
+  }
+
+  Eigen::Matrix3Xd points(3, 0);
+  for (const auto& T_shape : compound->shapes()) {
+    const Eigen::Matrix3Xd points_shape = T_shape.first * CollisionPoints(*T_shape.second);
+    points.conservativeResize(3, points.cols() + points_shape.cols());
+    points.rightCols(points_shape.cols()) = points_shape;
+  }
+  return points;
+}
+
+double Distance(const Eigen::Vector3d& mins_a, const Eigen::Vector3d& maxs_a,
+                const Eigen::Vector3d& mins_b, const Eigen::Vector3d& maxs_b) {
+  // Separation along each axis, or 0 if the intervals overlap
+  return (mins_a - maxs_b).cwiseMax(mins_b - maxs_a).cwiseMax(0.).norm();
+}
+
 }  // namespace
 
 namespace logic_opt {
@@ -51,7 +75,7 @@ CollisionConstraint::CollisionConstraint(World3& world, size_t t_collision, bool
       world_(world) {
 
   // Find the possible collision frames
-  const ctrl_utils::Tree<std::string, Frame>& frames = world.frames(t_collision);
+  const FrameTree frames = world.frames(t_collision);
   for (const std::pair<std::string, Frame>& key_val : frames.values()) {
     const std::string& frame = key_val.first;
     if (frame == World3::kWorldFrame || !world_.objects()->at(frame).collision ||
@@ -65,13 +89,39 @@ CollisionConstraint::CollisionConstraint(World3& world, size_t t_collision, bool
     }
   }
 
-  contact_ = ComputeError(Eigen::MatrixXd::Zero(kDof, world.num_timesteps()),
-                          &ee_closest_, &object_closest_);
+  // Objects without variable ancestors keep their bounding boxes
+  const Eigen::MatrixXd X_0 = Eigen::MatrixXd::Zero(kDof, world.num_timesteps());
+  ee_boxes_.resize(ee_frames_.size());
+  object_boxes_.resize(object_frames_.size());
+  is_object_static_.resize(object_frames_.size(), true);
+  for (size_t i = 0; i < object_frames_.size(); i++) {
+    for (int id = frames.id(object_frames_[i]); id != FrameTree::kNoParent; id = frames.parent(id)) {
+      if (frames.idx_var(id) >= 0) is_object_static_[i] = false;
+    }
+
+    const Eigen::Isometry3d T_to_world = world_.T_to_world(object_frames_[i], X_0, t_collision);
+    const auto aabb = world_.objects()->at(object_frames_[i]).collision->aabb(T_to_world);
+    object_boxes_[i] = { aabb.mins(), aabb.maxs() };
+  }
+
+  // Distance fields are queried with the vertices of the ee
+  for (const std::string& object_frame : object_frames_) {
+    if (!world_.objects()->at(object_frame).sdf) continue;
+    ee_points_.reserve(ee_frames_.size());
+    for (const std::string& ee_frame : ee_frames_) {
+      ee_points_.push_back(CollisionPoints(*world_.objects()->at(ee_frame).collision));
+    }
+    break;
+  }
+
+  contact_ = ComputeError(X_0, &ee_closest_, &object_closest_);
 }
 
 void CollisionConstraint::Evaluate(Eigen::Ref<const Eigen::MatrixXd> X,
                                    Eigen::Ref<Eigen::VectorXd> constraints) {
-  contact_ = ComputeError(X, &ee_closest_, &object_closest_);
+  if (UpdateEvaluate()) {
+    contact_ = ComputeError(X, &ee_closest_, &object_closest_);
+  }
 
   const double dist = contact_ ? contact_->depth : -kMaxDist;
   constraints(0) = 0.5 * std::abs(dist) * dist;
@@ -81,37 +131,30 @@ void CollisionConstraint::Evaluate(Eigen::Ref<const Eigen::MatrixXd> X,
 
 void CollisionConstraint::Jacobian(Eigen::Ref<const Eigen::MatrixXd> X,
                                    Eigen::Ref<Eigen::VectorXd> Jacobian) {
+  if (UpdateJacobian()) {
+    contact_ = ComputeError(X, &ee_closest_, &object_closest_);
+  }
   if (!contact_ || ee_closest_.empty() || object_closest_.empty()) {
     Constraint::Jacobian(X, Jacobian);
     return;
   }
-  // Jacobian.head<3>() = -std::abs(contact_->depth) * contact_->normal;
-
-  Eigen::MatrixXd X_h = X;
-  for (size_t i = 0; i < kDof; i++) {
-    const double h = i < 3 ? kH : kH_ori;
-    double& x_it = X_h(i, t_start());
-    const double x_it_0 = x_it;
-    x_it = x_it_0 + h;
-    const double x_err_hp = ComputeDistance(X_h, ee_closest_, object_closest_, kMaxDist);
-    x_it = x_it_0 - h;
-    const double x_err_hn = ComputeDistance(X_h, ee_closest_, object_closest_, kMaxDist);
-    x_it = x_it_0;
-    const double dx_h = 0.5 * (std::abs(x_err_hp) * x_err_hp - std::abs(x_err_hn) * x_err_hn) / (2. * h);
-
-    if (contact_->depth > 0 && std::abs(dx_h) > 0.5) {
-      // If the contact distance is small, ncollide will clip it to 0, which
-      // will make either x_err_hp or x_err_hn 0, and dx_h will become huge. Get
-      // around this by leaving the Jacobian element 0.
-
-      std::stringstream ss;
-      ss << "CollisionConstraint::Jacobian(): Ill-conditioned J(" << i << ","
-         << t_start() << "): " << dx_h << " " << " " << x_err_hp << " " << x_err_hn << " " << std::endl;
-      // throw std::runtime_error(ss.str());
-    }
 
-    Jacobian(i) = dx_h;
-  }
+  // The control frame pose is x + R(w) in its parent (target) frame. To first
+  // order, the depth changes with the motion of the ee witness point along the
+  // contact normal, both of which are expressed in the ee frame.
+  const Eigen::Isometry3d T_ee_to_control = world_.T_to_frame(ee_closest_, control_frame(), X, t_start());
+  const Eigen::Isometry3d T_control_to_target = world_.T_control_to_target(X, t_start());
+  const Eigen::Vector3d p_control = T_ee_to_control * contact_->world1;
+  const Eigen::Vector3d normal = T_control_to_target.linear() * T_ee_to_control.linear() *
+                                 contact_->normal;
+
+  // d/dX 0.5 * |depth| * depth = |depth| * normal^T [I, dR(w) p_control / dw]
+  const auto x_r = X.block<3,1>(3, t_start());
+  const Eigen::AngleAxisd aa(x_r.norm(), x_r.normalized());
+  const double abs_depth = std::abs(contact_->depth);
+  Jacobian.head<3>() = abs_depth * normal;
+  Jacobian.tail<3>() = abs_depth * ctrl_utils::ExpMapJacobian(aa, p_control).transpose() * normal;
+
   Constraint::Jacobian(X, Jacobian);
 }
 
@@ -123,34 +166,67 @@ void CollisionConstraint::JacobianIndices(Eigen::Ref<Eigen::ArrayXi> idx_i,
   idx_j.setLinSpaced(kDof, var_t, var_t + kDof - 1);
 }
 
+void CollisionConstraint::Hessian(Eigen::Ref<const Eigen::MatrixXd> X,
+                                  Eigen::Ref<const Eigen::VectorXd> lambda,
+                                  Eigen::Ref<Eigen::SparseMatrix<double>> Hessian) {
+  // Gauss-Newton approximation of 0.5 * |depth| * depth
+  GaussNewtonHessian(X, lambda, Hessian);
+}
+
+void CollisionConstraint::HessianStructure(Eigen::SparseMatrix<bool>& Hessian) {
+  GaussNewtonHessianStructure(Hessian);
+}
+
 std::optional<ncollide3d::query::Contact>
 CollisionConstraint::ComputeError(Eigen::Ref<const Eigen::MatrixXd> X,
                                   std::string* out_ee_closest,
                                   std::string* out_object_closest) {
 
+  // Broadphase: keep pairs whose bounding boxes are within kMaxDist
+  ComputeBoundingBoxes(X);
+  candidates_.clear();
+  for (size_t i = 0; i < ee_frames_.size(); i++) {
+    const BoundingBox& box_ee = ee_boxes_[i];
+    for (size_t j = 0; j < object_frames_.size(); j++) {
+      if (ignore_control_target_ && ee_frames_[i] == control_frame() &&
+          object_frames_[j] == target_frame()) continue;
+
+      const BoundingBox& box_object = object_boxes_[j];
+      const double dist = Distance(box_ee.mins, box_ee.maxs, box_object.mins, box_object.maxs);
+      if (dist > kMaxDist) continue;
+      candidates_.push_back({ dist, i, j });
+    }
+  }
+
+  // Visit the nearest pairs first so that penetrations prune the rest early
+  std::sort(candidates_.begin(), candidates_.end(),
+            [](const CandidatePair& a, const CandidatePair& b) { return a.dist < b.dist; });
+
   // Maximum distance: deepest penetration
   double max_dist = -std::numeric_limits<double>::infinity();
   std::optional<ncollide3d::query::Contact> max_contact;
   const std::string* ee_closest = nullptr;
   const std::string* object_closest = nullptr;
 
-  // Iterate over ee/object pairs
-  for (const std::string& ee_frame : ee_frames_) {
-    for (const std::string& object_frame : object_frames_) {
-      if (ignore_control_target_ && ee_frame == control_frame() && object_frame == target_frame()) continue;
-
-      // Filter out objects farther than -max_dist
-      const double proximity_dist = std::min(std::max(0., -max_dist), kMaxDist);
-      std::optional<ncollide3d::query::Contact> contact;
-      const double dist = ComputeDistance(X, ee_frame, object_frame, proximity_dist, &contact);
-      if (!contact || dist <= max_dist) continue;
-
-      // Update deepest penetration
-      max_dist = dist;
-      max_contact = contact;
-      ee_closest = &ee_frame;
-      object_closest = &object_frame;
-    }
+  // Narrow phase
+  for (const CandidatePair& candidate : candidates_) {
+    // Filter out objects farther than -max_dist
+    const double proximity_dist = std::min(std::max(0., -max_dist), kMaxDist);
+    if (candidate.dist > proximity_dist) break;
+
+    const std::string& ee_frame = ee_frames_[candidate.idx_ee];
+    const std::string& object_frame = object_frames_[candidate.idx_object];
+    std::optional<ncollide3d::query::Contact> contact;
+    const double dist = world_.objects()->at(object_frame).sdf ?
+        ComputeSdfDistance(X, candidate.idx_ee, object_frame, proximity_dist, &contact) :
+        ComputeDistance(X, ee_frame, object_frame, proximity_dist, &contact);
+    if (!contact || dist <= max_dist) continue;
+
+    // Update deepest penetration
+    max_dist = dist;
+    max_contact = contact;
+    ee_closest = &ee_frame;
+    object_closest = &object_frame;
   }
 
   // Output closest ee/object pair
@@ -166,21 +242,21 @@ CollisionConstraint::ComputeError(Eigen::Ref<const Eigen::MatrixXd> X,
     }
   }
 
-  // Reorder closest ee/object for next iteration
-  if (ee_closest != nullptr) {
-    auto it_ee = std::find(ee_frames_.begin(), ee_frames_.end(), *ee_closest);
-    if (it_ee != ee_frames_.begin()) {
-      std::iter_swap(it_ee, ee_frames_.begin());
-    }
+  return max_contact;
+}
+
+void CollisionConstraint::ComputeBoundingBoxes(Eigen::Ref<const Eigen::MatrixXd> X) {
+  for (size_t i = 0; i < ee_frames_.size(); i++) {
+    const Eigen::Isometry3d T_to_world = world_.T_to_world(ee_frames_[i], X, t_start());
+    const auto aabb = world_.objects()->at(ee_frames_[i]).collision->aabb(T_to_world);
+    ee_boxes_[i] = { aabb.mins(), aabb.maxs() };
   }
-  if (object_closest != nullptr) {
-    auto it_object = std::find(object_frames_.begin(), object_frames_.end(), *object_closest);
-    if (it_object != object_frames_.begin()) {
-      std::iter_swap(it_object, object_frames_.begin());
-    }
+  for (size_t i = 0; i < object_frames_.size(); i++) {
+    if (is_object_static_[i]) continue;
+    const Eigen::Isometry3d T_to_world = world_.T_to_world(object_frames_[i], X, t_start());
+    const auto aabb = world_.objects()->at(object_frames_[i]).collision->aabb(T_to_world);
+    object_boxes_[i] = { aabb.mins(), aabb.maxs() };
   }
-
-  return max_contact;
 }
 
 double CollisionConstraint::ComputeDistance(Eigen::Ref<const Eigen::MatrixXd> X,
@@ -205,4 +281,41 @@ double CollisionConstraint::ComputeDistance(Eigen::Ref<const Eigen::MatrixXd> X,
   return dist;
 }
 
+double CollisionConstraint::ComputeSdfDistance(Eigen::Ref<const Eigen::MatrixXd> X, size_t idx_ee,
+                                               const std::string& object_frame, double max_dist,
+                                               std::optional<ncollide3d::query::Contact>* out_contact) const {
+
+  const SignedDistanceField& sdf = *world_.objects()->at(object_frame).sdf;
+  const Eigen::Isometry3d T_ee_to_object = world_.T_to_frame(ee_frames_[idx_ee], object_frame, X, t_start());
+
+  // Find the deepest ee vertex
+  const Eigen::Matrix3Xd& points = ee_points_[idx_ee];
+  double min_dist = std::numeric_limits<double>::infinity();
+  Eigen::Vector3d grad_min;
+  int idx_min = -1;
+  for (int i = 0; i < points.cols(); i++) {
+    Eigen::Vector3d grad;
+    const double dist = sdf.Distance(T_ee_to_object * points.col(i), &grad);
+    if (dist >= min_dist) continue;
+    min_dist = dist;
+    grad_min = grad;
+    idx_min = i;
+  }
+
+  if (idx_min < 0 || min_dist > max_dist) {
+    if (out_contact != nullptr) out_contact->reset();
+    return -kMaxDist;
+  }
+
+  // The depth increases against the distance gradient
+  const Eigen::Vector3d normal = -(T_ee_to_object.linear().transpose() * grad_min).normalized();
+  const Eigen::Vector3d point = points.col(idx_min);
+
+  // Depth is positive if penetrating, negative otherwise
+  if (out_contact != nullptr) {
+    *out_contact = ncollide3d::query::Contact{ point, point + min_dist * normal, normal, -min_dist };
+  }
+  return -min_dist;
+}
+
 }  // namespace logic_opt
@@ -0,0 +1,136 @@
+/**
+ * constraint.cc
+ *
+ * Copyright 2026. All Rights Reserved.
+ *
+ * Created: October 17, 2026
+ * Authors: Toki Migimatsu
+ */
+
+#include "logic_opt/constraints/constraint.h"
+
+#include <algorithm>  // std::lower_bound, std::min
+#include <cassert>    // assert
+#include <map>        // std::map
+
+namespace logic_opt {
+
+void Constraint::FiniteDifferenceJacobian(Eigen::Ref<const Eigen::MatrixXd> X,
+                                          const ErrorFunction& error,
+                                          Eigen::Ref<const Eigen::VectorXd> h,
+                                          Eigen::Ref<Eigen::VectorXd> Jacobian,
+                                          size_t idx_begin, size_t idx_end,
+                                          const Eigen::VectorXd* error_0) {
+  if (fd_columns_.empty()) ComputeColumns();
+  idx_end = std::min(idx_end, len_jacobian());
+
+  // Reuse per-thread buffers across calls. The perturbation buffer is only
+  // synced with X when the iterate changes, since every perturbed column is
+  // restored afterwards. Iterates are unique across optimizations, and the
+  // optimizer never changes X without starting a new iterate.
+  thread_local Eigen::MatrixXd X_h;
+  thread_local Eigen::VectorXd error_hp;
+  thread_local Eigen::VectorXd error_hn;
+  thread_local const double* x_synced = nullptr;
+  thread_local size_t iterate_synced = kNoIterate;
+  if (iterate_ == kNoIterate || iterate_ != iterate_synced || X.data() != x_synced ||
+      X_h.rows() != X.rows() || X_h.cols() != X.cols()) {
+    X_h = X;
+  }
+  assert(X_h == X);
+  iterate_synced = kNoIterate;  // Invalid until the perturbations are restored
+  error_hp.resize(num_constraints());
+  error_hn.resize(num_constraints());
+
+  double* x_h = X_h.data();
+  const double* x = X.data();
+  const size_t dof = X.rows();
+  for (const Column& column : fd_columns_) {
+    // Skip variables without requested entries
+    auto it_begin = std::lower_bound(column.idx_entries.begin(), column.idx_entries.end(), idx_begin);
+    if (it_begin == column.idx_entries.end() || *it_begin >= idx_end) continue;
+
+    const int j = column.var;
+    const double h_j = h(j % dof);
+    x_h[j] = x[j] + h_j;
+    error(X_h, error_hp);
+    if (error_0 == nullptr) {
+      x_h[j] = x[j] - h_j;
+      error(X_h, error_hn);
+    }
+    x_h[j] = x[j];
+
+    for (auto it = it_begin; it != column.idx_entries.end() && *it < idx_end; ++it) {
+      const int i = idx_i_(*it);
+      Jacobian(*it) = error_0 == nullptr ? (error_hp(i) - error_hn(i)) / (2. * h_j)
+                                         : (error_hp(i) - (*error_0)(i)) / h_j;
+    }
+  }
+  x_synced = X.data();
+  iterate_synced = iterate_;
+}
+
+void Constraint::GaussNewtonHessian(Eigen::Ref<const Eigen::MatrixXd> X,
+                                    Eigen::Ref<const Eigen::VectorXd> lambda,
+                                    Eigen::Ref<Eigen::SparseMatrix<double>> Hessian) {
+  if (idx_i_.size() != len_jacobian()) ComputeSparsity();
+  is_caching_outputs_ = true;
+
+  // Only evaluate again if the optimizer hasn't already at this iterate.
+  // Constraints may leave entries untouched, e.g. without a contact.
+  if (iterate_ == kNoIterate || iterate_cached_constraints_ != iterate_) {
+    cached_constraints_.setZero(num_constraints());
+    Evaluate(X, cached_constraints_);
+  }
+  if (iterate_ == kNoIterate || iterate_cached_jacobian_ != iterate_) {
+    cached_jacobian_.setZero(len_jacobian());
+    Jacobian(X, cached_jacobian_);
+  }
+  const Eigen::VectorXd& constraints = cached_constraints_;
+  const Eigen::VectorXd& J = cached_jacobian_;
+
+  // sign(r) * dr/dX^T * dr/dX = J^T * J / (|r| * r) = J^T * J / 2c
+  for (size_t a = 0; a < len_jacobian(); a++) {
+    const int i = idx_i_(a);
+    if (lambda(i) == 0. || constraints(i) == 0.) continue;
+    const double scale = lambda(i) * J(a) / (2. * constraints(i));
+    for (size_t b = 0; b < len_jacobian(); b++) {
+      if (idx_i_(b) != i || idx_j_(b) > idx_j_(a)) continue;
+      Hessian.coeffRef(idx_j_(a), idx_j_(b)) += scale * J(b);
+    }
+  }
+}
+
+void Constraint::GaussNewtonHessianStructure(Eigen::SparseMatrix<bool>& Hessian) {
+  if (idx_i_.size() != len_jacobian()) ComputeSparsity();
+
+  for (size_t a = 0; a < len_jacobian(); a++) {
+    for (size_t b = 0; b < len_jacobian(); b++) {
+      if (idx_i_(b) != idx_i_(a) || idx_j_(b) > idx_j_(a)) continue;
+      Hessian.coeffRef(idx_j_(a), idx_j_(b)) = true;
+    }
+  }
+}
+
+void Constraint::ComputeSparsity() {
+  idx_i_ = Eigen::ArrayXi::Zero(len_jacobian());
+  idx_j_ = Eigen::ArrayXi::Zero(len_jacobian());
+  JacobianIndices(idx_i_, idx_j_);
+}
+
+void Constraint::ComputeColumns() {
+  ComputeSparsity();
+
+  // Collect the entries of each variable, in increasing order
+  std::map<int, std::vector<size_t>> var_entries;
+  for (size_t idx = 0; idx < len_jacobian(); idx++) {
+    var_entries[idx_j_(idx)].push_back(idx);
+  }
+
+  fd_columns_.reserve(var_entries.size());
+  for (std::pair<const int, std::vector<size_t>>& key_val : var_entries) {
+    fd_columns_.push_back({ key_val.first, std::move(key_val.second) });
+  }
+}
+
+}  // namespace logic_opt
@@ -116,6 +116,13 @@ Constraint::Type MultiConstraint::constraint_type(size_t idx_constraint) const {
   throw std::out_of_range("MultiConstraint::constraint_type(): Constraint index out of range.");
 }
 
+void MultiConstraint::set_iterate(size_t iterate) {
+  Constraint::set_iterate(iterate);
+  for (const std::unique_ptr<Constraint>& c : constraints_) {
+    c->set_iterate(iterate);
+  }
+}
+
 void MultiConstraint::OpenConstraintLog(const std::string& filepath) {
   for (const std::unique_ptr<Constraint>& c : constraints_) {
     c->OpenConstraintLog(filepath);
@@ -44,28 +44,21 @@ PickConstraint::PickConstraint(World3& world, size_t t_pick, const std::string&
 
 void PickConstraint::Evaluate(Eigen::Ref<const Eigen::MatrixXd> X,
                               Eigen::Ref<Eigen::VectorXd> constraints) {
-  const Object3& ee = world_.objects()->at(control_frame());
-  const Object3& object = world_.objects()->at(target_frame());
-  const Eigen::Isometry3d T_ee_to_object = world_.T_control_to_target(X, t_start());
-  const auto& x_ee = T_ee_to_object.translation();
-
-  // Project ee onto object
-  const auto projection = object.collision->project_point(Eigen::Isometry3d::Identity(), x_ee, false);
-  const double sign = projection.is_inside ? -1 : 1;
-
-  // Linearize object surface at projection point
-  dx_err_ = projection.point - x_ee;
-  x_err_ = sign * dx_err_.norm();
-  x_ee_ = x_ee;
+  if (UpdateEvaluate()) {
+    ComputeError(X);
+  }
 
   // constraints(0) = x_err_;
-  constraints(0) = 0.5 * sign * x_err_ * x_err_;
+  constraints(0) = 0.5 * std::abs(x_err_) * x_err_;
 
   Constraint::Evaluate(X, constraints);
 }
 
 void PickConstraint::Jacobian(Eigen::Ref<const Eigen::MatrixXd> X,
                               Eigen::Ref<Eigen::VectorXd> Jacobian) {
+  if (UpdateJacobian()) {
+    ComputeError(X);
+  }
   if (dx_err_.norm() > std::numeric_limits<double>::epsilon()) {
     dx_err_.normalize();
   }
@@ -94,4 +87,20 @@ void PickConstraint::JacobianIndices(Eigen::Ref<Eigen::ArrayXi> idx_i,
   idx_j.setLinSpaced(3, var_t, var_t + 2);
 }
 
+void PickConstraint::ComputeError(Eigen::Ref<const Eigen::MatrixXd> X) {
+  const Object3& ee = world_.objects()->at(control_frame());
+  const Object3& object = world_.objects()->at(target_frame());
+  const Eigen::Isometry3d T_ee_to_object = world_.T_control_to_target(X, t_start());
+  const auto& x_ee = T_ee_to_object.translation();
+
+  // Project ee onto object
+  const auto projection = object.collision->project_point(Eigen::Isometry3d::Identity(), x_ee, false);
+  const double sign = projection.is_inside ? -1 : 1;
+
+  // Linearize object surface at projection point
+  dx_err_ = projection.point - x_ee;
+  x_err_ = sign * dx_err_.norm();
+  x_ee_ = x_ee;
+}
+
 }  // namespace logic_opt
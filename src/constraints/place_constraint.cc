@@ -29,6 +29,7 @@ const double kH = 1e-5;
 const double kH_ori = 1e-2;
 #else  // PLACE_CONSTRAINT_SYMMETRIC_DIFFERENCE
 const double kH = 1e-4;
+const double kH_ori = 1e-2;
 #endif  // PLACE_CONSTRAINT_SYMMETRIC_DIFFERENCE
 
 const double kMaxToi = 100.;
@@ -110,6 +111,21 @@ void PlaceConstraint::NormalConstraint::JacobianIndices(Eigen::Ref<Eigen::ArrayX
   idx_j(1) = var_t + 4;
 }
 
+void PlaceConstraint::NormalConstraint::Hessian(Eigen::Ref<const Eigen::MatrixXd> X,
+                                                Eigen::Ref<const Eigen::VectorXd> lambda,
+                                                Eigen::Ref<Eigen::SparseMatrix<double>> Hessian) {
+  // H: lambda_0 at (wx, wx), lambda_1 at (wy, wy)
+  const size_t var_t = kDof * t_start();
+  Hessian.coeffRef(var_t + 3, var_t + 3) += lambda(0);
+  Hessian.coeffRef(var_t + 4, var_t + 4) += lambda(1);
+}
+
+void PlaceConstraint::NormalConstraint::HessianStructure(Eigen::SparseMatrix<bool>& Hessian) {
+  const size_t var_t = kDof * t_start();
+  Hessian.coeffRef(var_t + 3, var_t + 3) = true;
+  Hessian.coeffRef(var_t + 4, var_t + 4) = true;
+}
+
 PlaceConstraint::SupportAreaConstraint::SupportAreaConstraint(World3& world, size_t t_place,
                                                               const std::string& name_control,
                                                               const std::string& name_target)
@@ -161,7 +177,9 @@ PlaceConstraint::SupportAreaConstraint::SupportAreaConstraint(World3& world, siz
 
 void PlaceConstraint::SupportAreaConstraint::Evaluate(Eigen::Ref<const Eigen::MatrixXd> X,
                                                       Eigen::Ref<Eigen::VectorXd> constraints) {
-  x_err_ = ComputeError(X, &z_err_);
+  if (UpdateEvaluate()) {
+    x_err_ = ComputeError(X, &z_err_);
+  }
 
   // Constrain z height to be positive
   constraints(0) = -z_err_;
@@ -174,55 +192,27 @@ void PlaceConstraint::SupportAreaConstraint::Evaluate(Eigen::Ref<const Eigen::Ma
 
 void PlaceConstraint::SupportAreaConstraint::Jacobian(Eigen::Ref<const Eigen::MatrixXd> X,
                                                       Eigen::Ref<Eigen::VectorXd> Jacobian) {
-  // Jacobian for positive z
-  Jacobian(0) = -1.;
-
-  Eigen::MatrixXd X_h = X;
-
-  // Vary x, y
-  for (size_t i = 0; i < 2; i++) {
-    double& x_it = X_h(i, t_start());
-    const double x_it_0 = x_it;
-    x_it = x_it_0 + kH;
-    const Eigen::Vector3d x_err_hp = ComputeError(X_h);
-#ifdef PLACE_CONSTRAINT_SYMMETRIC_DIFFERENCE
-    x_it = x_it_0 - kH;
-    const Eigen::Vector3d x_err_hn = ComputeError(X_h);
-#endif  // PLACE_CONSTRAINT_SYMMETRIC_DIFFERENCE
-    x_it = x_it_0;
-
-#ifdef PLACE_CONSTRAINT_SYMMETRIC_DIFFERENCE
-    const Eigen::Vector3d dx_h = (x_err_hp - x_err_hn) / (2. * kH);
-#else  // PLACE_CONSTRAINT_SYMMETRIC_DIFFERENCE
-    const Eigen::Vector3d dx_h = (x_err_hp - x_err_) / kH;
-#endif  // PLACE_CONSTRAINT_SYMMETRIC_DIFFERENCE
-
-    Jacobian(1 + i) = dx_h(0);
-    Jacobian(3 + i) = dx_h(1);
-    Jacobian(6 + i) = dx_h(2);
+  if (UpdateJacobian()) {
+    x_err_ = ComputeError(X, &z_err_);
   }
 
-  // Vary wz
-  {
-    double& x_it = X_h(5, t_start());
-    const double x_it_0 = x_it;
-    x_it = x_it_0 + kH_ori;
-    const Eigen::Vector2d x_err_hp = ComputeError(X_h).tail<2>();
-#ifdef PLACE_CONSTRAINT_SYMMETRIC_DIFFERENCE
-    x_it = x_it_0 - kH_ori;
-    const Eigen::Vector2d x_err_hn = ComputeError(X_h).tail<2>();
-#endif  // PLACE_CONSTRAINT_SYMMETRIC_DIFFERENCE
-    x_it = x_it_0;
+  // Jacobian for positive z
+  Jacobian(0) = -1.;
 
+  // Vary x, y, wz
+  const auto error = [this](Eigen::Ref<const Eigen::MatrixXd> X_h,
+                            Eigen::Ref<Eigen::VectorXd> constraints) {
+    constraints(0) = 0.;
+    constraints.tail<3>() = ComputeError(X_h);
+  };
+  const Eigen::Vector6d h = (Eigen::Vector6d() << kH, kH, kH, kH_ori, kH_ori, kH_ori).finished();
 #ifdef PLACE_CONSTRAINT_SYMMETRIC_DIFFERENCE
-    const Eigen::Vector2d dx_h = (x_err_hp - x_err_hn) / (2. * kH_ori);
+  FiniteDifferenceJacobian(X, error, h, Jacobian, 1);
 #else  // PLACE_CONSTRAINT_SYMMETRIC_DIFFERENCE
-    const Eigen::Vector2d dx_h = (x_err_hp - x_err_.tail<2>()) / kH_ori;
+  const Eigen::VectorXd error_0 = (Eigen::Vector4d() << 0., x_err_).finished();
+  FiniteDifferenceJacobian(X, error, h, Jacobian, 1, kLenSupportAreaJacobian, &error_0);
 #endif  // PLACE_CONSTRAINT_SYMMETRIC_DIFFERENCE
 
-    Jacobian(3 + 2) = dx_h(0);
-    Jacobian(6 + 2) = dx_h(1);
-  }
   Constraint::Jacobian(X, Jacobian);
 }
 
@@ -92,7 +92,9 @@ PushConstraint::ContactAreaConstraint::ContactAreaConstraint(World3& world, size
 
 void PushConstraint::ContactAreaConstraint::Evaluate(Eigen::Ref<const Eigen::MatrixXd> X,
                                                      Eigen::Ref<Eigen::VectorXd> constraints) {
-  x_err_ = ComputeError(X);
+  if (UpdateEvaluate()) {
+    x_err_ = ComputeError(X);
+  }
   constraints(0) = 0.5 * x_err_.squaredNorm() - 1e-6;
 
   Constraint::Evaluate(X, constraints);
@@ -100,22 +102,19 @@ void PushConstraint::ContactAreaConstraint::Evaluate(Eigen::Ref<const Eigen::Mat
 
 void PushConstraint::ContactAreaConstraint::Jacobian(Eigen::Ref<const Eigen::MatrixXd> X,
                                                      Eigen::Ref<Eigen::VectorXd> Jacobian) {
+  if (UpdateJacobian()) {
+    x_err_ = ComputeError(X);
+  }
+
   // Jacobian for pusher position
   Jacobian.head<3>() = -x_err_;
 
-  Eigen::MatrixXd X_h = X;
-  for (size_t i = 3; i < kDof; i++) {
-    double& x_it = X_h(i, t_start());
-    const double x_it_0 = x_it;
-    x_it = x_it_0 + kH_ori;
-    const double x_err_hp = ComputeError(X_h).squaredNorm();
-    x_it = x_it_0 - kH_ori;
-    const double x_err_hn = ComputeError(X_h).squaredNorm();
-    x_it = x_it_0;
-
-    const double dx_h = 0.5 * (x_err_hp - x_err_hn) / (2. * kH_ori);
-    Jacobian(i) = dx_h;
-  }
+  // Vary pusher orientation
+  const auto error = [this](Eigen::Ref<const Eigen::MatrixXd> X_h,
+                            Eigen::Ref<Eigen::VectorXd> constraints) {
+    constraints(0) = 0.5 * ComputeError(X_h).squaredNorm();
+  };
+  FiniteDifferenceJacobian(X, error, Eigen::VectorXd::Constant(kDof, kH_ori), Jacobian, 3, kDof);
   Constraint::Jacobian(X, Jacobian);
 }
 
@@ -199,7 +198,9 @@ PushConstraint::DestinationConstraint::DestinationConstraint(World3& world, size
 
 void PushConstraint::DestinationConstraint::Evaluate(Eigen::Ref<const Eigen::MatrixXd> X,
                                                      Eigen::Ref<Eigen::VectorXd> constraints) {
-  z_err_ = ComputeError(X);
+  if (UpdateEvaluate()) {
+    z_err_ = ComputeError(X);
+  }
 
   // Constrain movement along z-axis to be 0
   constraints(0) = 0.5 * z_err_ * z_err_;
@@ -211,6 +212,9 @@ void PushConstraint::DestinationConstraint::Evaluate(Eigen::Ref<const Eigen::Mat
 
 void PushConstraint::DestinationConstraint::Jacobian(Eigen::Ref<const Eigen::MatrixXd> X,
                                                      Eigen::Ref<Eigen::VectorXd> Jacobian) {
+  if (UpdateJacobian()) {
+    z_err_ = ComputeError(X);
+  }
   Jacobian(0) = z_err_;
   const double dist = X.block<2,1>(0, t_start()).norm() - kWorkspaceRadius;
   Jacobian.tail<2>() = std::abs(dist) * X.block<2,1>(0, t_start()).normalized();
@@ -41,7 +41,9 @@ TouchConstraint::TouchConstraint(World3& world, size_t t_touch,
 
 void TouchConstraint::Evaluate(Eigen::Ref<const Eigen::MatrixXd> X,
                                Eigen::Ref<Eigen::VectorXd> constraints) {
-  contact_ = ComputeError(X);             // signed_dist
+  if (UpdateEvaluate()) {
+    contact_ = ComputeError(X);           // signed_dist
+  }
   if (!contact_) {
     std::cerr << name << "::Evaluate(): No contact!" << std::endl;
     std::cerr << X.col(t_start()).transpose() << std::endl;
@@ -56,43 +58,39 @@ void TouchConstraint::Evaluate(Eigen::Ref<const Eigen::MatrixXd> X,
 
 void TouchConstraint::Jacobian(Eigen::Ref<const Eigen::MatrixXd> X,
                                Eigen::Ref<Eigen::VectorXd> Jacobian) {
+  if (UpdateJacobian()) {
+    contact_ = ComputeError(X);
+  }
   if (!contact_) {
     Constraint::Jacobian(X, Jacobian);
     return;
   }
   Jacobian.head<3>() = std::abs(contact_->depth) * contact_->normal;
-  const double x_err = -contact_->depth;
 
   if (contact_->depth == 0.) throw std::runtime_error(name + "::Jacobian(): 0 depth.");
 
-  Eigen::MatrixXd X_h = X;
+  // Vary orientation
+  const auto error = [this](Eigen::Ref<const Eigen::MatrixXd> X_h,
+                            Eigen::Ref<Eigen::VectorXd> constraints) {
+    const auto contact = ComputeError(X_h);
+    if (contact && contact->depth == 0.) {
+      throw std::runtime_error(name + "::Jacobian(): 0 depth h.");
+    }
+    const double depth = contact ? contact->depth : 0.;
+    constraints(0) = -0.5 * std::abs(depth) * depth;
+  };
+  FiniteDifferenceJacobian(X, error, Eigen::VectorXd::Constant(kDof, kH), Jacobian, 3, kDof);
+
   for (size_t i = 3; i < kDof; i++) {
-    double& x_it = X_h(i, t_start());
-    const double x_it_0 = x_it;
-    x_it = x_it_0 + kH;
-    const auto contact_hp = ComputeError(X_h);
-    const double x_err_hp = contact_hp ? -contact_hp->depth : 0.;
-    if (contact_hp->depth == 0.) throw std::runtime_error(name + "::Jacobian(): 0 depth hp.");
-    x_it = x_it_0 - kH;
-    const auto contact_hn = ComputeError(X_h);
-    const double x_err_hn = contact_hn ? -contact_hn->depth : 0.;
-    if (contact_hn->depth == 0.) throw std::runtime_error(name + "::Jacobian(): 0 depth hn.");
-    x_it = x_it_0;
-
-    const double dx_h = 0.5 * (std::abs(x_err_hp) * x_err_hp - std::abs(x_err_hn) * x_err_hn) / (2. * kH);
-
-    if (contact_->depth < 0 && std::abs(dx_h) > 0.5) {
+    if (contact_->depth < 0 && std::abs(Jacobian(i)) > 0.5) {
       // If the contact distance is small, ncollide will clip it to 0, which
-      // will make either x_err_hp or x_err_hn 0, and dx_h will become huge. Get
-      // around this by leaving the Jacobian element 0.
-
+      // will make one of the perturbed errors 0, and the derivative will
+      // become huge.
       std::stringstream ss;
       ss << "TouchConstraint::Jacobian(): Ill-conditioned J(" << i << ","
-         << t_start() << "): " << dx_h << " " << contact_hn.has_value() << " " << x_err_hp << " " << x_err_hn << " " << x_err << std::endl;
+         << t_start() << "): " << Jacobian(i) << " " << -contact_->depth << std::endl;
       throw std::runtime_error(ss.str());
     }
-
-    Jacobian(i) = dx_h;
   }
   Constraint::Jacobian(X, Jacobian);
 }
@@ -105,6 +103,17 @@ void TouchConstraint::JacobianIndices(Eigen::Ref<Eigen::ArrayXi> idx_i,
   idx_j.head<kDof>().setLinSpaced(var_t, var_t + kDof - 1);
 }
 
+void TouchConstraint::Hessian(Eigen::Ref<const Eigen::MatrixXd> X,
+                              Eigen::Ref<const Eigen::VectorXd> lambda,
+                              Eigen::Ref<Eigen::SparseMatrix<double>> Hessian) {
+  // Gauss-Newton approximation of -0.5 * |depth| * depth
+  GaussNewtonHessian(X, lambda, Hessian);
+}
+
+void TouchConstraint::HessianStructure(Eigen::SparseMatrix<bool>& Hessian) {
+  GaussNewtonHessianStructure(Hessian);
+}
+
 std::optional<ncollide3d::query::Contact>
 TouchConstraint::ComputeError(Eigen::Ref<const Eigen::MatrixXd> X) const {
   const Object3& control = world_.objects()->at(control_frame());
@@ -11,8 +11,8 @@
 
 #include <algorithm>  // std::find, std::swap_iter, std::max, std::min
 #include <exception>  // std::runtime_error
+#include <iostream>   // std::cerr
 #include <limits>     // std::numeric_limits
-#include <sstream>    // std::stringstream
 #include <utility>    // std::move
 
 namespace {
@@ -36,6 +36,66 @@ std::string TargetFrame(const logic_opt::World3& world, size_t t) {
   throw std::runtime_error("TrajectoryConstraint::TargetFrame(): No target frame found.");
 }
 
+// Only the hull vertices of the ee contribute to the swept hull, so the rest
+// of the points are dropped once here instead of at every hull computation
+std::vector<std::array<double, 3>> AugmentedPoints(const std::vector<std::array<double, 3>>& points) {
+  const ncollide3d::shape::TriMesh hull = ncollide3d::transformation::convex_hull(points);
+
+  std::vector<std::array<double, 3>> augmented_points;
+  augmented_points.reserve(2 * hull.num_points());
+  for (size_t i = 0; i < hull.num_points(); i++) {
+    const Eigen::Ref<const Eigen::Vector3d> point = hull.point(i);
+    augmented_points.push_back({point(0), point(1), point(2)});
+  }
+  augmented_points.resize(2 * hull.num_points(), {0., 0., 0.});
+  return augmented_points;
+}
+
+// Relative tolerance for matching hull vertices to input points
+const double kVertexTolerance = 1e-9;
+
+// Find the index of the closest point in points for each hull vertex. Ncollide
+// copies the hull vertices from the input, so every vertex has a match up to
+// rounding. Returns an empty vector if a vertex can't be matched.
+std::vector<size_t> HullVertexIndices(const std::vector<std::array<double, 3>>& points,
+                                      const ncollide3d::shape::TriMesh& hull) {
+  Eigen::Map<const Eigen::Matrix3Xd> P(points[0].data(), 3, points.size());
+  const double tol = kVertexTolerance * (1. + P.cwiseAbs().maxCoeff());
+
+  std::vector<size_t> idx_vertices;
+  idx_vertices.reserve(hull.num_points());
+  for (size_t i = 0; i < hull.num_points(); i++) {
+    Eigen::Index idx;
+    const double dist_sq = (P.colwise() - hull.point(i)).colwise().squaredNorm().minCoeff(&idx);
+    if (dist_sq > tol * tol) return {};
+    idx_vertices.push_back(idx);
+  }
+  return idx_vertices;
+}
+
+// Distance from the hull boundary of the shallowest point that isn't a hull
+// vertex, or infinity if every point is a vertex
+double MinDepthInsideHull(const std::vector<std::array<double, 3>>& points,
+                          const std::vector<size_t>& idx_vertices) {
+  std::vector<bool> is_vertex(points.size(), false);
+  std::vector<std::array<double, 3>> vertices;
+  vertices.reserve(idx_vertices.size());
+  for (size_t idx : idx_vertices) {
+    is_vertex[idx] = true;
+    vertices.push_back(points[idx]);
+  }
+
+  const ncollide3d::shape::ConvexHull hull(vertices);
+  double min_depth = std::numeric_limits<double>::infinity();
+  for (size_t i = 0; i < points.size(); i++) {
+    if (is_vertex[i]) continue;
+    const Eigen::Map<const Eigen::Vector3d> point(points[i].data());
+    const auto projection = hull.project_point(Eigen::Isometry3d::Identity(), point, false);
+    min_depth = std::min(min_depth, (point - projection.point).norm());
+  }
+  return min_depth;
+}
+
 }  // namespace
 
 namespace logic_opt {
@@ -47,7 +107,7 @@ TrajectoryConstraint::TrajectoryConstraint(World3& world, size_t t_trajectory)
       world_(world) {
 
   // Find the possible collision frames
-  const ctrl_utils::Tree<std::string, Frame>& frames = world.frames(t_trajectory);
+  const FrameTree frames = world.frames(t_trajectory);
   for (const std::pair<std::string, Frame>& key_val : frames.values()) {
     const std::string& frame = key_val.first;
     if (frame == World3::kWorldFrame || !world_.objects()->at(frame).collision) continue;
@@ -71,75 +131,69 @@ TrajectoryConstraint::TrajectoryConstraint(World3& world, size_t t_trajectory)
       const ncollide3d::shape::TriMesh trimesh = shape->to_trimesh();
 
       std::vector<std::array<double, 3>> points;
-      points.reserve(2 * trimesh.num_points());
+      points.reserve(trimesh.num_points());
       for (size_t j = 0; j < trimesh.num_points(); j++) {
         const Eigen::Vector3d point = T * trimesh.point(j);
         points.push_back({point(0), point(1), point(2)});
       }
-      for (size_t j = 0; j < trimesh.num_points(); j++) {
-        points.push_back({0., 0., 0.});
-      }
-      augmented_ee_points_.push_back(std::move(points));
+      augmented_ee_points_.push_back(AugmentedPoints(points));
     }
   } else {
     const ncollide3d::shape::TriMesh trimesh = ee.collision->to_trimesh();
 
     std::vector<std::array<double, 3>> points;
-    points.reserve(2 * trimesh.num_points());
+    points.reserve(trimesh.num_points());
     for (size_t i = 0; i < trimesh.num_points(); i++) {
       const Eigen::Ref<const Eigen::Vector3d> point = trimesh.point(i);
       points.push_back({point(0), point(1), point(2)});
     }
-    for (size_t i = 0; i < trimesh.num_points(); i++) {
-      points.push_back({0., 0., 0.});
-    }
 
     augmented_ee_points_.reserve(1);
-    augmented_ee_points_.push_back(std::move(points));
+    augmented_ee_points_.push_back(AugmentedPoints(points));
+  }
+  idx_hull_vertices_.resize(augmented_ee_points_.size());
+  min_depths_dropped_.resize(augmented_ee_points_.size(), 0.);
+  ee_points_next_iterate_.reserve(augmented_ee_points_.size());
+  for (const std::vector<std::array<double, 3>>& ee_points : augmented_ee_points_) {
+    ee_points_next_iterate_.emplace_back(ee_points.size() / 2, std::array<double, 3>{0., 0., 0.});
   }
 }
 
 void TrajectoryConstraint::Evaluate(Eigen::Ref<const Eigen::MatrixXd> X,
                                     Eigen::Ref<Eigen::VectorXd> constraints) {
+  if (UpdateEvaluate()) {
+    x_err_ = ComputeError(X, &contact_, &object_closest_);
+  }
 
-  constraints(0) = ComputeError(X, &contact_, &object_closest_);
+  constraints(0) = x_err_;
 
   Constraint::Evaluate(X, constraints);
 }
 
 void TrajectoryConstraint::Jacobian(Eigen::Ref<const Eigen::MatrixXd> X,
                                     Eigen::Ref<Eigen::VectorXd> Jacobian) {
+  if (UpdateJacobian()) {
+    x_err_ = ComputeError(X, &contact_, &object_closest_);
+  }
   if (!contact_ || object_closest_.empty()) {
     Constraint::Jacobian(X, Jacobian);
     return;
   }
 
-  Eigen::MatrixXd X_h = X;
-  for (size_t t = 0; t < 2; t++) {
-    for (size_t i = 0; i < kDof; i++) {
-      const double h = i < 3 ? kH : kH_ori;
-      double& x_it = X_h(i, t_start() + t);
-      const double x_it_0 = x_it;
-      x_it = x_it_0 + h;
-      const double x_err_hp = ComputeJacobianError(X_h, control_frame(), object_closest_, kMaxDist);
-      x_it = x_it_0 - h;
-      const double x_err_hn = ComputeJacobianError(X_h, control_frame(), object_closest_, kMaxDist);
-      x_it = x_it_0;
-      const double dx_h = (x_err_hp - x_err_hn) / (2. * h);
-
-      if (contact_->depth > 0 && std::abs(dx_h) > 0.5) {
-        // If the contact distance is small, ncollide will clip it to 0, which
-        // will make either x_err_hp or x_err_hn 0, and dx_h will become huge. Get
-        // around this by leaving the Jacobian element 0.
-
-        std::stringstream ss;
-        ss << "TrajectoryConstraint::Jacobian(): Ill-conditioned J(" << i << ","
-           << t_start() + t << "): " << dx_h << " " << " " << x_err_hp << " " << x_err_hn << " " << std::endl;
-        std::cerr << ss.str();
-        // throw std::runtime_error(ss.str());
-      }
-
-      Jacobian(kDof*t + i) = dx_h;
+  const auto error = [this](Eigen::Ref<const Eigen::MatrixXd> X_h,
+                            Eigen::Ref<Eigen::VectorXd> constraints) {
+    constraints(0) = ComputeJacobianError(X_h, control_frame(), object_closest_, kMaxDist);
+  };
+  const Eigen::Vector6d h = (Eigen::Vector6d() << kH, kH, kH, kH_ori, kH_ori, kH_ori).finished();
+  FiniteDifferenceJacobian(X, error, h, Jacobian);
+
+  for (size_t i = 0; i < 2 * kDof; i++) {
+    if (contact_->depth > 0 && std::abs(Jacobian(i)) > 0.5) {
+      // If the contact distance is small, ncollide will clip it to 0, which
+      // will make one of the perturbed errors 0, and the derivative will
+      // become huge.
+      std::cerr << "TrajectoryConstraint::Jacobian(): Ill-conditioned J(" << i % kDof << ","
+                << t_start() + i / kDof << "): " << Jacobian(i) << std::endl;
     }
   }
   Constraint::Jacobian(X, Jacobian);
@@ -199,40 +253,69 @@ double TrajectoryConstraint::ComputeError(Eigen::Ref<const Eigen::MatrixXd> X,
 
 std::unique_ptr<ncollide3d::shape::Shape>
 TrajectoryConstraint::ComputeConvexHull(Eigen::Ref<const Eigen::MatrixXd> X,
-                                        const std::string& ee_frame) {
+                                        const std::string& ee_frame, bool is_perturbation) {
 
   const Eigen::Isometry3d T_ee_next_to_ee = world_.T_to_frame(target_frame(), ee_frame, X, t_start()) *
                                             world_.T_to_frame(ee_frame, target_frame(), X, t_start() + 1);
 
-  // Find trajectory convex hull of non-compound shapes
-  if (augmented_ee_points_.size() == 1) {
-    std::vector<std::array<double, 3>>& ee_points = augmented_ee_points_.front();
+  ncollide3d::shape::ShapeVector shapes;
+  shapes.reserve(augmented_ee_points_.size());
+  for (size_t i = 0; i < augmented_ee_points_.size(); i++) {
+    std::vector<std::array<double, 3>>& ee_points = augmented_ee_points_[i];
+    std::vector<size_t>& idx_vertices = idx_hull_vertices_[i];
     const size_t num_points = ee_points.size() / 2;
     Eigen::Map<const Eigen::Matrix3Xd> points(ee_points[0].data(), 3, num_points);
     Eigen::Map<Eigen::Matrix3Xd> points_next(ee_points[num_points].data(), 3, num_points);
-    for (size_t i = 0; i < num_points; i++) {
-      points_next.col(i) = T_ee_next_to_ee * points.col(i);
+    for (size_t j = 0; j < num_points; j++) {
+      points_next.col(j) = T_ee_next_to_ee * points.col(j);
+    }
+
+    // Recompute the hull topology only at unperturbed iterates. Perturbed
+    // hulls are built from the last hull vertices, which is exact as long as
+    // no other point can move outside that hull. Every point and every hull
+    // vertex moves by at most dx, so points deeper than 2 * dx stay inside.
+    Eigen::Map<Eigen::Matrix3Xd> points_next_iterate(ee_points_next_iterate_[i][0].data(), 3, num_points);
+    bool is_full_hull = !is_perturbation || idx_vertices.empty();
+    if (!is_full_hull) {
+      const double dx = (points_next - points_next_iterate).colwise().norm().maxCoeff();
+      is_full_hull = !(min_depths_dropped_[i] > 2. * dx);
+    }
+
+    std::unique_ptr<ncollide3d::shape::TriMesh> trimesh;
+    if (is_full_hull) {
+      trimesh = std::make_unique<ncollide3d::shape::TriMesh>(ncollide3d::transformation::convex_hull(ee_points));
     }
+    if (!is_perturbation) {
+      idx_vertices = HullVertexIndices(ee_points, *trimesh);
+      min_depths_dropped_[i] = idx_vertices.empty() ? 0. : MinDepthInsideHull(ee_points, idx_vertices);
+      points_next_iterate = points_next;
+    }
+
+    thread_local std::vector<std::array<double, 3>> hull_points;
+    hull_points.clear();
+    if (is_full_hull) {
+      hull_points = ee_points;
+    } else {
+      for (size_t idx : idx_vertices) hull_points.push_back(ee_points[idx]);
+    }
+
 #ifdef LOGIC_OPT_TRAJECTORY_CONVEX_HULL
-    return std::make_unique<ncollide3d::shape::ConvexHull>(ee_points);
+    std::unique_ptr<ncollide3d::shape::Shape> hull = std::make_unique<ncollide3d::shape::ConvexHull>(hull_points);
 #else  // LOGIC_OPT_TRAJECTORY_CONVEX_HULL
-    return std::make_unique<ncollide3d::shape::TriMesh>(ncollide3d::transformation::convex_hull(ee_points));
+    std::unique_ptr<ncollide3d::shape::Shape> hull;
+    if (augmented_ee_points_.size() > 1) {
+      // Ncollide doesn't support compound trimesh shapes
+      hull = std::make_unique<ncollide3d::shape::ConvexHull>(hull_points);
+    } else if (trimesh) {
+      hull = std::move(trimesh);
+    } else {
+      hull = std::make_unique<ncollide3d::shape::TriMesh>(ncollide3d::transformation::convex_hull(hull_points));
+    }
 #endif  // LOGIC_OPT_TRAJECTORY_CONVEX_HULL
-  }
 
-  // Find trajectory convex hull of compound shape components
-  ncollide3d::shape::ShapeVector shapes;
-  shapes.reserve(augmented_ee_points_.size());
-  for (std::vector<std::array<double, 3>>& ee_points : augmented_ee_points_) {
-    const size_t num_points = ee_points.size() / 2;
-    Eigen::Map<const Eigen::Matrix3Xd> points(ee_points[0].data(), 3, num_points);
-    Eigen::Map<Eigen::Matrix3Xd> points_next(ee_points[num_points].data(), 3, num_points);
-    for (size_t i = 0; i < num_points; i++) {
-      points_next.col(i) = T_ee_next_to_ee * points.col(i);
-    }
-    // Ncollide doesn't support compound trimesh shapes
-    shapes.push_back({ Eigen::Isometry3d::Identity(),
-                       std::make_unique<ncollide3d::shape::ConvexHull>(ee_points) });
+    // Return non-compound shapes directly
+    if (augmented_ee_points_.size() == 1) return hull;
+    shapes.push_back({ Eigen::Isometry3d::Identity(), std::move(hull) });
   }
   return std::make_unique<ncollide3d::shape::Compound>(std::move(shapes));
 }
@@ -263,7 +346,7 @@ double TrajectoryConstraint::ComputeJacobianError(Eigen::Ref<const Eigen::Matrix
                                                   const std::string& ee_frame,
                                                   const std::string& object_frame,
                                                   double max_dist) {
-  const auto ee_convex_hull = ComputeConvexHull(X, ee_frame);
+  const auto ee_convex_hull = ComputeConvexHull(X, ee_frame, true);
   const double dist = ComputeDistance(X, ee_frame, object_frame, ee_convex_hull, max_dist);
   return 0.5 * std::abs(dist) * dist;
 }
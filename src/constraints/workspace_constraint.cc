@@ -10,18 +10,18 @@
 #include "logic_opt/constraints/workspace_constraint.h"
 
 #include <algorithm>  // std::find, std::iter_swap, std::max, std::min
+#include <cmath>      // std::abs, std::sqrt
 #include <exception>  // std::runtime_error
 #include <limits>     // std::numeric_limits
 #include <sstream>    // std::stringstream
 #include <utility>    // std::move
+#include <vector>     // std::vector
 
 #include <ctrl_utils/math.h>
+#include <unsupported/Eigen/AutoDiff>
 
 namespace {
 
-const double kH = 1e-5;
-const double kH_ori = 1e-2;
-
 const double kMaxDist = 0.1;
 
 const double kWorkspaceRadius = 0.4;
@@ -62,21 +62,38 @@ void WorkspaceConstraint::Evaluate(Eigen::Ref<const Eigen::MatrixXd> X,
 
 void WorkspaceConstraint::Jacobian(Eigen::Ref<const Eigen::MatrixXd> X,
                                    Eigen::Ref<Eigen::VectorXd> Jacobian) {
-  Eigen::MatrixXd X_h = X;
-  for (size_t t = 0; t <= t_start(); t++) {
+  using AutoDiff = Eigen::AutoDiffScalar<Eigen::VectorXd>;
+  using std::sqrt;
+
+  // Only the variables of the ee's ancestors can move it
+  std::vector<size_t> idx_vars;
+  for (const auto& key_val : world_.frames(t_start()).ancestors(name_ee_)) {
+    const Frame& frame = key_val.second;
+    if (frame.is_variable()) idx_vars.push_back(frame.idx_var());
+  }
+
+  // Differentiate with respect to those variables only
+  World3::MatrixT<AutoDiff> X_ad = X.cast<AutoDiff>();
+  const size_t num_derivatives = kDof * idx_vars.size();
+  for (size_t k = 0; k < idx_vars.size(); k++) {
     for (size_t i = 0; i < kDof; i++) {
-      const double h = i < 3 ? kH : kH_ori;
-      double& x_it = X_h(i, t);
-      const double x_it_0 = x_it;
-      x_it = x_it_0 + h;
-      const double x_err_hp = ComputeError(X_h);
-      x_it = x_it_0 - h;
-      const double x_err_hn = ComputeError(X_h);
-      x_it = x_it_0;
-      const double dx_h = (x_err_hp - x_err_hn) / (2. * h);
-      Jacobian(kDof * t + i) = dx_h;
+      X_ad(i, idx_vars[k]) = AutoDiff(X(i, idx_vars[k]), num_derivatives, kDof * k + i);
     }
   }
+
+  const auto x_t = world_.Position(name_ee_, world_.kWorldFrame, X_ad, t_start());
+  const AutoDiff dist = sqrt(x_t.squaredNorm()) - kWorkspaceRadius;
+
+  // d/dX 0.5 * |dist| * dist = |dist| * d dist / dX
+  Jacobian.setZero();
+  if (dist.derivatives().size() == 0) {
+    Constraint::Jacobian(X, Jacobian);
+    return;
+  }
+  for (size_t k = 0; k < idx_vars.size(); k++) {
+    Jacobian.segment<kDof>(kDof * idx_vars[k]) =
+        std::abs(dist.value()) * dist.derivatives().segment<kDof>(kDof * k);
+  }
   Constraint::Jacobian(X, Jacobian);
 }
 
@@ -293,7 +293,7 @@ void TrajectoryOptimizationThread(const logic_opt::World3* world, const Eigen::M
     logic_opt::World3 sim_world(sim_objects);
     const std::string& control = world->control_frame(t_action);
     const std::string& target = world->target_frame(t_action);
-    const ctrl_utils::Tree<std::string, logic_opt::Frame>& tree = world->frames(t_action);
+    const logic_opt::FrameTree tree = world->frames(t_action);
 
     // Copy kinematic tree from world
     auto sim_objects_abs = std::make_shared<std::map<std::string, logic_opt::Object3>>(*sim_objects);
@@ -380,7 +380,7 @@ void TrajectoryOptimizationThread(const logic_opt::World3* world, const Eigen::M
 
 std::pair<std::set<std::string>, std::set<std::string>>
 ComputeCollisionPairs(const logic_opt::World3& world, size_t t_collision) {
-  const ctrl_utils::Tree<std::string, logic_opt::Frame>& frames = world.frames(t_collision);
+  const logic_opt::FrameTree frames = world.frames(t_collision);
   std::pair<std::set<std::string>, std::set<std::string>> ee_obstacles;
   for (const std::pair<std::string, logic_opt::Frame>& key_val : frames.values()) {
     const std::string& frame = key_val.first;
@@ -764,7 +764,7 @@ void UpdateObjectStates(ctrl_utils::RedisClient& redis, const logic_opt::World3&
   const Eigen::Isometry3d& T_ee_to_world_prev = sim.objects->at(kEeFrame).T_to_parent();
   const Eigen::Isometry3d dT = T_ee_to_world * T_ee_to_world_prev.inverse();
 
-  const ctrl_utils::Tree<std::string, logic_opt::Frame> frame_tree = world.frames(idx_trajectory);
+  const logic_opt::FrameTree frame_tree = world.frames(idx_trajectory);
   for (const auto& key_val : frame_tree.descendants(control_frame)) {
     // Only check frames between control frame and ee
     const std::string& frame = key_val.first;
@@ -0,0 +1,349 @@
+/**
+ * convex_decomposition.cc
+ *
+ * Copyright 2026. All Rights Reserved.
+ *
+ * Created: October 17, 2026
+ * Authors: Toki Migimatsu
+ */
+
+#include "logic_opt/convex_decomposition.h"
+
+#include <algorithm>  // std::max, std::max_element, std::min, std::nth_element, std::sort, std::transform, std::unique
+#include <cctype>     // std::tolower
+#include <cmath>      // std::sqrt
+#include <cstdint>    // uint32_t, uint64_t
+#include <cstdio>     // std::rename
+#include <cstring>    // std::memcpy
+#include <fstream>    // std::ifstream, std::ofstream
+#include <iostream>   // std::cerr
+#include <iterator>   // std::istreambuf_iterator
+#include <limits>     // std::numeric_limits
+#include <map>        // std::map
+#include <mutex>      // std::lock_guard, std::mutex
+#include <numeric>    // std::iota
+#include <sstream>    // std::stringstream
+#include <string>     // std::to_string
+#include <tuple>      // std::make_tuple
+#include <utility>    // std::move
+#include <sys/stat.h>  // ::stat
+#include <unistd.h>   // ::getpid
+
+namespace {
+
+using ::logic_opt::ConvexDecomposition;
+using Point = ConvexDecomposition::Point;
+using Triangle = ConvexDecomposition::Triangle;
+
+// Increment when the file format or the decomposition changes
+const uint64_t kCacheVersion = 2;
+const uint64_t kMagic = 0x314c4c5548504f4cULL;  // "LOPHULL1"
+
+// Parts flatter than this don't have a well-defined convex hull
+const double kMinThickness = 1e-6;
+
+struct Part {
+  std::vector<size_t> idx_triangles;
+  std::vector<Point> hull;  // Hull vertices
+  double concavity = 0.;
+  bool is_splittable = true;
+};
+
+// FNV-1a
+void Hash(const void* data, size_t size, uint64_t& hash) {
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+  for (size_t i = 0; i < size; i++) {
+    hash ^= bytes[i];
+    hash *= 0x100000001b3ULL;
+  }
+}
+
+bool ParseBinaryStl(const std::string& data, std::vector<Triangle>& triangles) {
+  // 80 byte header, triangle count, then a normal, three vertices, and an
+  // attribute per triangle
+  if (data.size() < 84) return false;
+  uint32_t num_triangles;
+  std::memcpy(&num_triangles, data.data() + 80, sizeof(num_triangles));
+  if (data.size() != 84 + 50 * static_cast<size_t>(num_triangles)) return false;
+
+  triangles.resize(num_triangles);
+  for (size_t i = 0; i < num_triangles; i++) {
+    float vertices[9];
+    std::memcpy(vertices, data.data() + 84 + 50 * i + 12, sizeof(vertices));
+    for (size_t j = 0; j < 9; j++) {
+      triangles[i][j / 3][j % 3] = vertices[j];
+    }
+  }
+  return !triangles.empty();
+}
+
+bool ParseAsciiStl(const std::string& data, std::vector<Triangle>& triangles) {
+  // Only the vertex lines matter
+  std::stringstream ss(data);
+  std::string token;
+  Triangle triangle;
+  size_t idx_vertex = 0;
+  while (ss >> token) {
+    if (token != "vertex") continue;
+    Point& point = triangle[idx_vertex % 3];
+    if (!(ss >> point[0] >> point[1] >> point[2])) return false;
+    if (++idx_vertex % 3 == 0) triangles.push_back(triangle);
+  }
+  return !triangles.empty();
+}
+
+/**
+ * Read a binary or ASCII STL file and hash its contents. Returns false if the
+ * file can't be read or has no triangles.
+ */
+bool ReadStl(const std::string& filename, std::vector<Triangle>& triangles, uint64_t& hash) {
+  std::ifstream file(filename, std::ios::binary);
+  if (!file) return false;
+  const std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  Hash(data.data(), data.size(), hash);
+
+  // ASCII files start with "solid", but some binary headers do too, so fall
+  // back to binary if the text doesn't parse
+  const size_t idx_start = std::min(data.find_first_not_of(" \t\r\n"), data.size());
+  if (data.compare(idx_start, 5, "solid") == 0) {
+    if (ParseAsciiStl(data, triangles)) return true;
+    triangles.clear();
+  }
+  return ParseBinaryStl(data, triangles);
+}
+
+Eigen::Vector3d Centroid(const Triangle& triangle) {
+  return (Eigen::Map<const Eigen::Vector3d>(triangle[0].data()) +
+          Eigen::Map<const Eigen::Vector3d>(triangle[1].data()) +
+          Eigen::Map<const Eigen::Vector3d>(triangle[2].data())) / 3.;
+}
+
+/**
+ * Compute the hull and concavity of the part. Returns false if the part is
+ * too flat.
+ */
+bool ComputeHull(const std::vector<Triangle>& triangles, Part& part) {
+  std::vector<Point> points;
+  points.reserve(3 * part.idx_triangles.size());
+  for (size_t idx : part.idx_triangles) {
+    points.insert(points.end(), triangles[idx].begin(), triangles[idx].end());
+  }
+  std::sort(points.begin(), points.end());
+  points.erase(std::unique(points.begin(), points.end()), points.end());
+  if (points.size() < 4) return false;
+
+  // Check the smallest principal extent of the points
+  Eigen::Map<const Eigen::Matrix3Xd> P(points[0].data(), 3, points.size());
+  const Eigen::Matrix3Xd P_centered = P.colwise() - P.rowwise().mean();
+  const Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> eig(P_centered * P_centered.transpose() /
+                                                           points.size());
+  if (std::sqrt(std::max(0., eig.eigenvalues()(0))) < kMinThickness) return false;
+
+  const ncollide3d::shape::TriMesh hull = ncollide3d::transformation::convex_hull(points);
+  part.hull.clear();
+  part.hull.reserve(hull.num_points());
+  for (size_t i = 0; i < hull.num_points(); i++) {
+    const Eigen::Ref<const Eigen::Vector3d> point = hull.point(i);
+    part.hull.push_back({point(0), point(1), point(2)});
+  }
+
+  // Points of convex parts lie on the hull surface. Vertices alone miss
+  // concavities of extruded shapes, whose vertices all lie on the end caps,
+  // so triangle centroids are checked too.
+  const auto Concavity = [&hull](const Eigen::Vector3d& point) {
+    const auto projection = hull.project_point(Eigen::Isometry3d::Identity(), point, false);
+    return (point - projection.point).norm();
+  };
+  part.concavity = 0.;
+  for (int i = 0; i < P.cols(); i++) {
+    part.concavity = std::max(part.concavity, Concavity(P.col(i)));
+  }
+  for (size_t idx : part.idx_triangles) {
+    part.concavity = std::max(part.concavity, Concavity(Centroid(triangles[idx])));
+  }
+  return true;
+}
+
+/**
+ * Split the part at the median triangle centroid along its longest axis.
+ * Returns false if either half can't be hulled.
+ */
+bool Split(const std::vector<Triangle>& triangles, const Part& part, Part& left, Part& right) {
+  if (part.idx_triangles.size() < 2) return false;
+
+  Eigen::Vector3d mins = Eigen::Vector3d::Constant(std::numeric_limits<double>::infinity());
+  Eigen::Vector3d maxs = -mins;
+  for (size_t idx : part.idx_triangles) {
+    const Eigen::Vector3d centroid = Centroid(triangles[idx]);
+    mins = mins.cwiseMin(centroid);
+    maxs = maxs.cwiseMax(centroid);
+  }
+  int axis;
+  (maxs - mins).maxCoeff(&axis);
+
+  std::vector<size_t> idx_triangles = part.idx_triangles;
+  const auto it_mid = idx_triangles.begin() + idx_triangles.size() / 2;
+  std::nth_element(idx_triangles.begin(), it_mid, idx_triangles.end(),
+                   [&triangles, axis](size_t a, size_t b) {
+                     return Centroid(triangles[a])(axis) < Centroid(triangles[b])(axis);
+                   });
+  left.idx_triangles.assign(idx_triangles.begin(), it_mid);
+  right.idx_triangles.assign(it_mid, idx_triangles.end());
+  return ComputeHull(triangles, left) && ComputeHull(triangles, right);
+}
+
+bool LoadHulls(const std::string& filename, uint64_t key, std::vector<std::vector<Point>>& hulls) {
+  std::ifstream file(filename, std::ios::binary);
+  if (!file) return false;
+
+  uint64_t magic = 0;
+  uint64_t file_key = 0;
+  uint64_t num_hulls = 0;
+  file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+  file.read(reinterpret_cast<char*>(&file_key), sizeof(file_key));
+  file.read(reinterpret_cast<char*>(&num_hulls), sizeof(num_hulls));
+  if (!file || magic != kMagic || file_key != key || num_hulls == 0) return false;
+
+  hulls.resize(num_hulls);
+  for (std::vector<Point>& hull : hulls) {
+    uint64_t num_points = 0;
+    file.read(reinterpret_cast<char*>(&num_points), sizeof(num_points));
+    if (!file) return false;
+    hull.resize(num_points);
+    file.read(reinterpret_cast<char*>(hull.data()), num_points * sizeof(Point));
+  }
+  return static_cast<bool>(file);
+}
+
+void SaveHulls(const std::string& filename, uint64_t key, const std::vector<std::vector<Point>>& hulls) {
+  // Write to a temporary file first so that readers never see partial files.
+  // The name is unique per process so that concurrent writers don't collide.
+  const std::string filename_tmp = filename + "." + std::to_string(::getpid()) + ".tmp";
+  {
+    std::ofstream file(filename_tmp, std::ios::binary);
+    const uint64_t num_hulls = hulls.size();
+    file.write(reinterpret_cast<const char*>(&kMagic), sizeof(kMagic));
+    file.write(reinterpret_cast<const char*>(&key), sizeof(key));
+    file.write(reinterpret_cast<const char*>(&num_hulls), sizeof(num_hulls));
+    for (const std::vector<Point>& hull : hulls) {
+      const uint64_t num_points = hull.size();
+      file.write(reinterpret_cast<const char*>(&num_points), sizeof(num_points));
+      file.write(reinterpret_cast<const char*>(hull.data()), num_points * sizeof(Point));
+    }
+    if (!file) {
+      // The decomposition is still usable, e.g. with read-only resources
+      std::cerr << "ConvexDecomposition::LoadOrCompute(): Failed to write " << filename_tmp << "." << std::endl;
+      return;
+    }
+  }
+  if (std::rename(filename_tmp.c_str(), filename.c_str()) != 0) {
+    std::cerr << "ConvexDecomposition::LoadOrCompute(): Failed to rename " << filename_tmp << "." << std::endl;
+  }
+}
+
+}  // namespace
+
+namespace logic_opt {
+
+constexpr double ConvexDecomposition::kDefaultMaxConcavity;
+constexpr size_t ConvexDecomposition::kDefaultMaxParts;
+
+ConvexDecomposition::ConvexDecomposition(const std::vector<Triangle>& triangles,
+                                         double max_concavity, size_t max_parts) {
+  std::vector<Part> parts(1);
+  parts[0].idx_triangles.resize(triangles.size());
+  std::iota(parts[0].idx_triangles.begin(), parts[0].idx_triangles.end(), 0);
+  if (!ComputeHull(triangles, parts[0])) return;
+
+  while (parts.size() < max_parts) {
+    // Split the most concave part
+    auto it = std::max_element(parts.begin(), parts.end(), [](const Part& a, const Part& b) {
+      return (a.is_splittable ? a.concavity : -1.) < (b.is_splittable ? b.concavity : -1.);
+    });
+    if (!it->is_splittable || it->concavity <= max_concavity) break;
+
+    Part left, right;
+    if (!Split(triangles, *it, left, right)) {
+      it->is_splittable = false;
+      continue;
+    }
+    *it = std::move(left);
+    parts.push_back(std::move(right));
+  }
+
+  // Warn if the part limit was hit before the mesh was convex enough
+  double concavity = 0.;
+  for (const Part& part : parts) {
+    if (part.is_splittable) concavity = std::max(concavity, part.concavity);
+  }
+  if (concavity > max_concavity) {
+    std::cerr << "ConvexDecomposition(): Stopped at " << parts.size() << " parts with concavity "
+              << concavity << " > max_concavity " << max_concavity << "." << std::endl;
+  }
+
+  hulls_.reserve(parts.size());
+  for (Part& part : parts) {
+    hulls_.push_back(std::move(part.hull));
+  }
+}
+
+std::unique_ptr<ConvexDecomposition>
+ConvexDecomposition::LoadOrCompute(const std::string& filename_mesh, double max_concavity,
+                                   size_t max_parts) {
+  std::string extension = filename_mesh.substr(std::min(filename_mesh.rfind('.'), filename_mesh.size()));
+  std::transform(extension.begin(), extension.end(), extension.begin(),
+                 [](unsigned char c) { return std::tolower(c); });
+  if (extension != ".stl") return nullptr;
+
+  // Reuse decompositions already loaded by this process unless the file changed
+  struct stat stat_mesh;
+  if (::stat(filename_mesh.c_str(), &stat_mesh) != 0) return nullptr;
+  const auto key_loaded = std::make_tuple(filename_mesh, stat_mesh.st_mtime, stat_mesh.st_size,
+                                          max_concavity, max_parts);
+  static std::map<decltype(key_loaded), std::vector<std::vector<Point>>> loaded;
+  static std::mutex mtx_loaded;
+  {
+    std::lock_guard<std::mutex> lock(mtx_loaded);
+    auto it = loaded.find(key_loaded);
+    if (it != loaded.end()) {
+      auto decomposition = std::make_unique<ConvexDecomposition>();
+      decomposition->hulls_ = it->second;
+      return decomposition;
+    }
+  }
+
+  // Key the cache by the mesh contents and the decomposition parameters
+  uint64_t key = 0xcbf29ce484222325ULL;
+  Hash(&kCacheVersion, sizeof(kCacheVersion), key);
+  Hash(&max_concavity, sizeof(max_concavity), key);
+  Hash(&max_parts, sizeof(max_parts), key);
+  std::vector<Triangle> triangles;
+  if (!ReadStl(filename_mesh, triangles, key)) return nullptr;
+
+  const std::string filename_cache = filename_mesh + ".hulls";
+  auto decomposition = std::make_unique<ConvexDecomposition>();
+  if (!LoadHulls(filename_cache, key, decomposition->hulls_)) {
+    *decomposition = ConvexDecomposition(triangles, max_concavity, max_parts);
+    if (decomposition->hulls_.empty()) return nullptr;
+    SaveHulls(filename_cache, key, decomposition->hulls_);
+  }
+
+  std::lock_guard<std::mutex> lock(mtx_loaded);
+  loaded.emplace(key_loaded, decomposition->hulls_);
+  return decomposition;
+}
+
+std::unique_ptr<ncollide3d::shape::Shape> ConvexDecomposition::MakeShape() const {
+  if (hulls_.size() == 1) {
+    return std::make_unique<ncollide3d::shape::ConvexHull>(hulls_.front());
+  }
+
+  ncollide3d::shape::ShapeVector shapes;
+  shapes.reserve(hulls_.size());
+  for (const std::vector<Point>& hull : hulls_) {
+    shapes.push_back({ Eigen::Isometry3d::Identity(), std::make_unique<ncollide3d::shape::ConvexHull>(hull) });
+  }
+  return std::make_unique<ncollide3d::shape::Compound>(std::move(shapes));
+}
+
+}  // namespace logic_opt
@@ -7,17 +7,20 @@
  * Authors: Toki Migimatsu
  */
 
-#include <algorithm>  // std::max, std::transform
+#include <algorithm>  // std::find, std::max, std::min, std::transform
 #include <atomic>     // std::atomic
 #include <cctype>     // std::tolower
 #include <chrono>     // std::chrono
 #include <cmath>      // M_PI
+#include <condition_variable>  // std::condition_variable
 #include <csignal>    // std::signal, std::sig_atomic_t
 #include <fstream>    // std::ofstream
-#include <future>     // std::future
 #include <iostream>   // std::cout
 #include <map>        // std::map
+#include <memory>     // std::shared_ptr
+#include <mutex>      // std::mutex, std::unique_lock
 #include <numeric>    // std::accumulate
+#include <queue>      // std::priority_queue
 #include <string>     // std::string
 #include <thread>     // std::thread
 #include <time.h>     // ::gmtime_r, std::strftime
@@ -30,6 +33,7 @@
 #include <ctrl_utils/yaml.h>
 
 #include "logic_opt/control/opspace_controller.h"
+#include "logic_opt/convex_decomposition.h"
 #include "logic_opt/optimization/constraints.h"
 #include "logic_opt/optimization/ipopt.h"
 #include "logic_opt/optimization/nlopt.h"
@@ -39,6 +43,8 @@
 #include "logic_opt/planning/a_star.h"
 #include "logic_opt/planning/breadth_first_search.h"
 #include "logic_opt/planning/depth_first_search.h"
+#include "logic_opt/planning/heuristics.h"
+#include "logic_opt/planning/parallel_breadth_first_search.h"
 #include "logic_opt/planning/pddl.h"
 #include "logic_opt/planning/planner.h"
 
@@ -52,6 +58,9 @@ namespace {
 
 const std::string kEeFrame = "ee";
 
+// Maximum constraint violation of a successful optimization
+const double kMaxConstraintViolation = 1e-3;
+
 AtomicQueue<std::tuple<Eigen::MatrixXd, logic_opt::World3, std::vector<logic_opt::Planner::Node>>> g_redis_queue;
 std::atomic<int> g_num_optimizations = { 0 };
 std::condition_variable g_cv_optimizations_clear;
@@ -101,7 +110,7 @@ Args ParseArgs(int argc, char *argv[]) {
     } else if (arg == "--with-scalar-constraints") {
       parsed_args.with_scalar_constraints = true;
     } else if (arg == "--with-hessian") {
-      parsed_args.with_hessian = false;
+      parsed_args.with_hessian = true;
     } else {
       break;
     }
@@ -153,6 +162,12 @@ void ValidateYaml(const YAML::Node& yaml) {
   CheckRequired(yaml, {"world", "objects", "//array", "graphics"});
   CheckRequired(yaml, {"world", "objects", "//array", "graphics", "//array", "geometry"});
   CheckRequired(yaml, {"world", "objects", "//array", "graphics", "//array", "geometry", "type"});
+  if (yaml["world"]["sdf"]) {
+    CheckRequired(yaml, {"world", "sdf", "objects"});
+  }
+  if (yaml["world"]["convex_decomposition"]) {
+    CheckRequired(yaml, {"world", "convex_decomposition", "objects"});
+  }
 }
 
 void ValidateWorldObjects(const std::shared_ptr<const std::map<std::string, logic_opt::Object3>>& world_objects,
@@ -258,87 +273,265 @@ std::map<std::string, ConstraintConstructor> CreateConstraintFactory() {
   return actions;
 };
 
-std::future<Eigen::MatrixXd> AsyncOptimize(const std::vector<logic_opt::Planner::Node>& plan,
-                                           const std::shared_ptr<const std::map<std::string, logic_opt::Object3>>& world_objects,
-                                           const std::unique_ptr<logic_opt::Optimizer>& optimizer,
-                                           const std::map<std::string, ConstraintConstructor>& constraint_factory,
-                                           const spatial_dyn::ArticulatedBody& const_ab) {
-
-  std::function<Eigen::MatrixXd()> optimize = [plan, world_objects, &optimizer,
-                                               &constraint_factory, &const_ab]() -> Eigen::MatrixXd {
-    try {
-      spatial_dyn::ArticulatedBody ab = const_ab;
-
-      logic_opt::World3 world(world_objects);
-
-      // Initialize kinematic tree
-      for (const auto& P : plan.begin()->propositions()) {
-        if (P.predicate() != "on") continue;
-        assert(P.variables().size() == 2);
-        const std::string control_frame = P.variables()[0]->getName();
-        const std::string target_frame = P.variables()[1]->getName();
-        world.AttachFrame(control_frame, target_frame, 0, true);
-        // TODO: Find better way to do this (also in controller)
-      }
+/**
+ * Optimize the plan and push the result to the redis thread unless the
+ * optimization was cancelled. Returns true if the result is feasible.
+ */
+bool Optimize(const std::vector<logic_opt::Planner::Node>& plan,
+              const std::shared_ptr<const std::map<std::string, logic_opt::Object3>>& world_objects,
+              const std::unique_ptr<logic_opt::Optimizer>& optimizer,
+              const std::map<std::string, ConstraintConstructor>& constraint_factory,
+              const spatial_dyn::ArticulatedBody& const_ab,
+              const std::atomic<bool>& is_cancelled) {
+  try {
+    spatial_dyn::ArticulatedBody ab = const_ab;
+
+    logic_opt::World3 world(world_objects);
+
+    // Initialize kinematic tree
+    for (const auto& P : plan.begin()->propositions()) {
+      if (P.predicate() != "on") continue;
+      assert(P.variables().size() == 2);
+      const std::string control_frame = P.variables()[0]->getName();
+      const std::string target_frame = P.variables()[1]->getName();
+      world.AttachFrame(control_frame, target_frame, 0, true);
+      // TODO: Find better way to do this (also in controller)
+    }
 
-      // Create objectives
-      logic_opt::Objectives objectives;
-      objectives.emplace_back(new logic_opt::LinearVelocityObjective3(world, kEeFrame));
-      objectives.emplace_back(new logic_opt::AngularVelocityObjective(world, kEeFrame, 3.));
+    // Create objectives
+    logic_opt::Objectives objectives;
+    objectives.emplace_back(new logic_opt::LinearVelocityObjective3(world, kEeFrame));
+    objectives.emplace_back(new logic_opt::AngularVelocityObjective(world, kEeFrame, 3.));
 
-      // Create task constraints
-      logic_opt::Constraints constraints;
-      size_t t = 0;
-      for (const logic_opt::Planner::Node& node : plan) {
-        const logic_opt::Proposition& action = node.action();
-        constraints.emplace_back(constraint_factory.at(action.predicate())(action, world, ab, t));
-        t += constraints.back()->num_timesteps();
+    // Create task constraints
+    logic_opt::Constraints constraints;
+    size_t t = 0;
+    for (const logic_opt::Planner::Node& node : plan) {
+      const logic_opt::Proposition& action = node.action();
+      constraints.emplace_back(constraint_factory.at(action.predicate())(action, world, ab, t));
+      t += constraints.back()->num_timesteps();
+    }
+
+    // Return to home at end of trajectory
+    const logic_opt::Proposition& home_action = plan.front().action();
+    constraints.emplace_back(constraint_factory.at(home_action.predicate())(home_action, world, ab, t));
+    t += constraints.back()->num_timesteps();
+
+    // Check num timesteps
+    const size_t T = world.num_timesteps();
+    if (t != T) throw std::runtime_error("Constraint timesteps must equal T.");
+
+    // Create variables
+    logic_opt::FrameVariables<3> variables(T);
+
+    // Optimize
+    logic_opt::Optimizer::OptimizationData data;
+    data.is_cancelled = &is_cancelled;
+    auto t_start = std::chrono::high_resolution_clock::now();
+    Eigen::MatrixXd X_optimal = optimizer->Trajectory(variables, objectives, constraints, &data);
+    auto t_end = std::chrono::high_resolution_clock::now();
+    if (is_cancelled || !g_runloop) return false;
+
+    std::cout << "Optimization time: " << std::chrono::duration_cast<std::chrono::duration<double>>(t_end - t_start).count() << std::endl << std::endl;
+    std::cout << X_optimal << std::endl << std::endl;
+    bool is_feasible = true;
+    for (const std::unique_ptr<logic_opt::Constraint>& c : constraints) {
+      Eigen::VectorXd f(c->num_constraints());
+      c->Evaluate(X_optimal, f);
+      std::cout << c->name << ":" << std::endl;
+      for (size_t i = 0; i < c->num_constraints(); i++) {
+        const bool is_inequality = c->constraint_type(i) == logic_opt::Constraint::Type::kInequality;
+        std::cout << "  " << (is_inequality ? "<" : "=") << " : " << f(i) << std::endl;
+        if ((is_inequality ? f(i) : std::abs(f(i))) > kMaxConstraintViolation) is_feasible = false;
       }
+    }
+    std::cout << world << std::endl << std::endl;
 
-      // Return to home at end of trajectory
-      const logic_opt::Proposition& home_action = plan.front().action();
-      constraints.emplace_back(constraint_factory.at(home_action.predicate())(home_action, world, ab, t));
-      t += constraints.back()->num_timesteps();
+    // Push results
+    ++g_num_optimizations;
+    g_redis_queue.Emplace(X_optimal, world, plan);
+
+    return is_feasible;
+  } catch (const std::exception& e) {
+    std::cerr << "Optimize(): Exception " << e.what() << std::endl;
+    return false;
+  }
+}
 
-      // Check num timesteps
-      const size_t T = world.num_timesteps();
-      if (t != T) throw std::runtime_error("Constraint timesteps must equal T.");
-
-      // Create variables
-      logic_opt::FrameVariables<3> variables(T);
-
-      // Optimize
-      auto t_start = std::chrono::high_resolution_clock::now();
-      Eigen::MatrixXd X_optimal = optimizer->Trajectory(variables, objectives, constraints);
-      auto t_end = std::chrono::high_resolution_clock::now();
-
-      std::cout << "Optimization time: " << std::chrono::duration_cast<std::chrono::duration<double>>(t_end - t_start).count() << std::endl << std::endl;
-      std::cout << X_optimal << std::endl << std::endl;
-      for (const std::unique_ptr<logic_opt::Constraint>& c : constraints) {
-        Eigen::VectorXd f(c->num_constraints());
-        c->Evaluate(X_optimal, f);
-        std::cout << c->name << ":" << std::endl;
-        for (size_t i = 0; i < c->num_constraints(); i++) {
-          std::cout << "  "
-                    << (c->constraint_type(i) == logic_opt::Constraint::Type::kInequality ?
-                        "<" : "=")
-                    << " : " << f(i) << std::endl;
-        }
+/**
+ * Fixed-size pool of optimization workers.
+ *
+ * Plans are optimized in order of increasing priority value, then in
+ * submission order. Each job has a cancellation token that stops its
+ * optimization. Once max_successes optimizations have succeeded, all pending
+ * and running jobs are cancelled and new submissions are ignored.
+ */
+class OptimizationPool {
+
+ public:
+
+  using Plan = std::vector<logic_opt::Planner::Node>;
+  using OptimizeFunction = std::function<bool(const Plan&, const std::atomic<bool>&)>;
+
+  /**
+   * @param optimize Returns true if the optimization succeeded.
+   * @param num_workers Number of workers (0 uses all cores).
+   * @param max_successes Successes after which to stop (0 for unlimited).
+   */
+  OptimizationPool(const OptimizeFunction& optimize, size_t num_workers, size_t max_successes)
+      : kMaxSuccesses(max_successes), optimize_(optimize) {
+    if (num_workers == 0) num_workers = std::max(1u, std::thread::hardware_concurrency());
+    max_running_ = num_workers;
+    workers_.reserve(num_workers);
+    for (size_t i = 0; i < num_workers; i++) {
+      workers_.emplace_back(&OptimizationPool::Work, this);
+    }
+  }
+
+  ~OptimizationPool() {
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      is_terminated_ = true;
+      CancelJobs();
+    }
+    cv_jobs_.notify_all();
+    for (std::thread& worker : workers_) worker.join();
+  }
+
+  /**
+   * Queue the plan and return its cancellation token.
+   */
+  std::shared_ptr<std::atomic<bool>> Submit(const Plan& plan, size_t priority) {
+    auto is_cancelled = std::make_shared<std::atomic<bool>>(false);
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      if (is_finished_) {
+        *is_cancelled = true;
+        return is_cancelled;
       }
-      std::cout << world << std::endl << std::endl;
+      queue_.push({ plan, priority, num_submitted_++, is_cancelled });
+    }
+    cv_jobs_.notify_one();
+    return is_cancelled;
+  }
+
+  /**
+   * Wait until all queued jobs have finished or been cancelled.
+   */
+  void Wait() {
+    std::unique_lock<std::mutex> lock(mtx_);
+    cv_idle_.wait(lock, [this]() { return queue_.empty() && running_.empty(); });
+  }
+
+  /**
+   * Wait for at most the given timeout. Returns true if all queued jobs have
+   * finished or been cancelled.
+   */
+  bool WaitFor(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mtx_);
+    return cv_idle_.wait_for(lock, timeout, [this]() { return queue_.empty() && running_.empty(); });
+  }
+
+  /**
+   * Cancel all pending and running jobs. Jobs submitted afterwards still run.
+   */
+  void CancelAll() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    CancelJobs();
+    cv_idle_.notify_all();
+  }
+
+  /**
+   * Limit the number of jobs that run at the same time, e.g. while the
+   * planner is using some of the cores. Running jobs are not interrupted.
+   */
+  void set_max_running(size_t max_running) {
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      max_running_ = std::max<size_t>(max_running, 1);
+    }
+    cv_jobs_.notify_all();
+  }
 
-      // Push results
-      g_redis_queue.Emplace(X_optimal, world, plan);
+  size_t num_workers() const { return workers_.size(); }
 
-      return X_optimal;
-    } catch (const std::exception& e) {
-      std::cerr << "AsyncOptimize(): Exception " << e.what() << std::endl;
-      throw e;
+  /**
+   * Whether the success limit has been reached.
+   */
+  bool is_finished() const {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return is_finished_;
+  }
+
+ private:
+
+  struct Job {
+    Plan plan;
+    size_t priority;
+    size_t idx_submit;
+    std::shared_ptr<std::atomic<bool>> is_cancelled;
+  };
+
+  struct Compare {
+    bool operator()(const Job& left, const Job& right) const {
+      if (left.priority != right.priority) return left.priority > right.priority;
+      return left.idx_submit > right.idx_submit;
     }
   };
 
-  return std::async(std::launch::async, std::move(optimize));
-}
+  void Work() {
+    std::unique_lock<std::mutex> lock(mtx_);
+    while (true) {
+      cv_jobs_.wait(lock, [this]() {
+        return is_terminated_ || (!queue_.empty() && running_.size() < max_running_);
+      });
+      if (is_terminated_) return;
+
+      Job job = queue_.top();
+      queue_.pop();
+      running_.push_back(job.is_cancelled);
+
+      lock.unlock();
+      const bool is_success = !*job.is_cancelled && optimize_(job.plan, *job.is_cancelled);
+      lock.lock();
+
+      running_.erase(std::find(running_.begin(), running_.end(), job.is_cancelled));
+      if (is_success && ++num_successes_ == kMaxSuccesses) {
+        is_finished_ = true;
+        CancelJobs();
+      }
+      cv_idle_.notify_all();
+    }
+  }
+
+  // Requires the lock
+  void CancelJobs() {
+    for (const std::shared_ptr<std::atomic<bool>>& is_cancelled : running_) {
+      *is_cancelled = true;
+    }
+    for (; !queue_.empty(); queue_.pop()) {
+      *queue_.top().is_cancelled = true;
+    }
+  }
+
+  const size_t kMaxSuccesses;
+  const OptimizeFunction optimize_;
+
+  mutable std::mutex mtx_;
+  std::condition_variable cv_jobs_;
+  std::condition_variable cv_idle_;
+
+  std::priority_queue<Job, std::vector<Job>, Compare> queue_;
+  std::vector<std::shared_ptr<std::atomic<bool>>> running_;
+  size_t num_submitted_ = 0;
+  size_t num_successes_ = 0;
+  size_t max_running_ = 0;
+  bool is_finished_ = false;
+  bool is_terminated_ = false;
+
+  std::vector<std::thread> workers_;
+
+};
 
 }  // namespace
 
@@ -376,6 +569,45 @@ int main(int argc, char *argv[]) {
     // ee.set_T_to_parent(Eigen::Quaterniond::Identity(), spatial_dyn::Position(ab, -1, ee_offset));
   }
 
+  // Load or precompute distance fields of static obstacles
+  if (yaml["world"]["sdf"]) {
+    const YAML::Node& sdf = yaml["world"]["sdf"];
+    const double resolution = sdf["resolution"] ? sdf["resolution"].as<double>()
+                                                : logic_opt::SignedDistanceField::kDefaultResolution;
+    const double margin = sdf["margin"] ? sdf["margin"].as<double>()
+                                        : logic_opt::SignedDistanceField::kDefaultMargin;
+    const std::filesystem::path path_cache = std::filesystem::path(args.yaml).parent_path() /
+                                             (sdf["cache"] ? sdf["cache"].as<std::string>() : ".sdf_cache");
+    std::filesystem::create_directories(path_cache);
+    for (const YAML::Node& node : sdf["objects"]) {
+      const std::string name = node.as<std::string>();
+      if (world_objects->find(name) == world_objects->end()) {
+        throw std::invalid_argument("ValidateYaml(): world.sdf.objects contains unknown object " + name + ".");
+      }
+      logic_opt::Object3& object = world_objects->at(name);
+      if (!object.collision) continue;
+      object.sdf = logic_opt::SignedDistanceField::LoadOrCompute(object.graphics, *object.collision,
+                                                                 path_cache.string(), resolution, margin);
+    }
+  }
+
+  // Approximate mesh collisions with convex parts. Distance fields above are
+  // computed from the exact meshes.
+  if (yaml["world"]["convex_decomposition"]) {
+    const YAML::Node& decomposition = yaml["world"]["convex_decomposition"];
+    const double max_concavity = decomposition["max_concavity"] ?
+        decomposition["max_concavity"].as<double>() : logic_opt::ConvexDecomposition::kDefaultMaxConcavity;
+    const size_t max_parts = decomposition["max_parts"] ?
+        decomposition["max_parts"].as<size_t>() : logic_opt::ConvexDecomposition::kDefaultMaxParts;
+    for (const YAML::Node& node : decomposition["objects"]) {
+      const std::string name = node.as<std::string>();
+      if (world_objects->find(name) == world_objects->end()) {
+        throw std::invalid_argument("ValidateYaml(): world.convex_decomposition.objects contains unknown object " + name + ".");
+      }
+      world_objects->at(name).DecomposeMeshes(max_concavity, max_parts);
+    }
+  }
+
   // Initialize planner
   const std::filesystem::path path_resources = std::filesystem::path(args.yaml).parent_path();
   const std::string domain = (path_resources / yaml["planner"]["domain"].as<std::string>()).string();
@@ -392,7 +624,9 @@ int main(int argc, char *argv[]) {
   if (name_optimizer == "nlopt") {
     optimizer = std::make_unique<logic_opt::Nlopt>();
   } else if (name_optimizer == "ipopt") {
-    optimizer = std::make_unique<logic_opt::Ipopt>(yaml["optimizer"]["ipopt"]);
+    auto ipopt = std::make_unique<logic_opt::Ipopt>(yaml["optimizer"]["ipopt"]);
+    if (args.with_hessian) ipopt->options().use_hessian = true;
+    optimizer = std::move(ipopt);
   }
 
   // Create constraints
@@ -401,23 +635,75 @@ int main(int argc, char *argv[]) {
   // Create redis listener
   std::thread redis_thread(RedisPublishTrajectories, ab, world_objects);
 
+  // Create optimization workers
+  const size_t num_workers = yaml["optimizer"]["num_workers"] ?
+      yaml["optimizer"]["num_workers"].as<size_t>() : 0;
+  const size_t max_successes = yaml["optimizer"]["max_successes"] ?
+      yaml["optimizer"]["max_successes"].as<size_t>() : 0;
+  OptimizationPool optimization_pool(
+      [&world_objects, &optimizer, &constraint_factory, &ab](const OptimizationPool::Plan& plan,
+                                                             const std::atomic<bool>& is_cancelled) {
+        return Optimize(plan, world_objects, optimizer, constraint_factory, ab, is_cancelled);
+      }, num_workers, max_successes);
+
   // Perform search
-  std::list<std::future<Eigen::MatrixXd>> optimization_results;
   auto t_start = std::chrono::high_resolution_clock::now();
-  logic_opt::BreadthFirstSearch<logic_opt::Planner::Node> bfs(planner.root(), yaml["planner"]["depth"].as<size_t>());
-  for (const std::vector<logic_opt::Planner::Node>& plan : bfs) {
-    for (const logic_opt::Planner::Node& node : plan) {
-      std::cout << node << std::endl;
+  const size_t depth = yaml["planner"]["depth"].as<size_t>();
+  const logic_opt::DuplicateDetection duplicate_detection = yaml["planner"]["duplicate_detection"] ?
+      logic_opt::ParseDuplicateDetection(yaml["planner"]["duplicate_detection"].as<std::string>()) :
+      logic_opt::DuplicateDetection::kNone;
+  const std::string name_heuristic = yaml["planner"]["heuristic"] ?
+      yaml["planner"]["heuristic"].as<std::string>() : "none";
+  const size_t num_threads = yaml["planner"]["num_threads"] ?
+      yaml["planner"]["num_threads"].as<size_t>() : 0;
+
+  // Leave the planner's cores to it until the search is done. A planner that
+  // uses every core is only busy while expanding the frontier, so the
+  // optimizations are not held back in that case.
+  const size_t num_cores = std::max(1u, std::thread::hardware_concurrency());
+  const size_t num_planner_threads = name_heuristic != "none" ? 1 :
+                                     num_threads == 0 ? num_cores : std::min(num_threads, num_cores);
+  if (num_planner_threads < num_cores) {
+    optimization_pool.set_max_running(std::min(optimization_pool.num_workers(),
+                                               num_cores - num_planner_threads));
+  }
+
+  size_t num_plans = 0;
+  auto SubmitPlans = [&optimization_pool, &num_plans](auto& search) {
+    for (const std::vector<logic_opt::Planner::Node>& plan : search) {
+      if (!g_runloop || optimization_pool.is_finished()) break;
+      for (const logic_opt::Planner::Node& node : plan) {
+        std::cout << node << std::endl;
+      }
+      // Optimize shorter plans first. Breadth-first search already yields
+      // plans in this order, but A* may not.
+      optimization_pool.Submit(plan, plan.size());
+      std::cout << "Optimize " << ++num_plans << std::endl;
     }
-    std::future<Eigen::MatrixXd> future_result = AsyncOptimize(plan, world_objects, optimizer,
-                                                               constraint_factory, ab);
-    optimization_results.push_back(std::move(future_result));
-    ++g_num_optimizations;
-    std::cout << "Optimize " << g_num_optimizations << std::endl;
+  };
+  if (name_heuristic == "none") {
+    logic_opt::ParallelBreadthFirstSearch<logic_opt::Planner::Node> bfs(planner.root(), depth,
+                                                                        duplicate_detection, num_threads);
+    SubmitPlans(bfs);
+  } else {
+    const logic_opt::RelaxedPlanningGraph rpg(planner.actions(), planner.goal(), planner.atoms().size(),
+                                              logic_opt::ParseHeuristicType(name_heuristic));
+    auto Heuristic = [&rpg](const logic_opt::Planner::Node& node) -> size_t {
+      return rpg.Evaluate(node.state());
+    };
+    logic_opt::AStar<logic_opt::Planner::Node, decltype(Heuristic)> astar(Heuristic, planner.root(), depth,
+                                                                         duplicate_detection);
+    SubmitPlans(astar);
   }
+  optimization_pool.set_max_running(optimization_pool.num_workers());
   auto t_end = std::chrono::high_resolution_clock::now();
   std::cout << "Planning time: " << std::chrono::duration_cast<std::chrono::duration<double>>(t_end - t_start).count() << std::endl << std::endl;
 
+  // Poll for interrupts, which cancel the remaining optimizations
+  while (!optimization_pool.WaitFor(std::chrono::milliseconds(100))) {
+    if (!g_runloop) optimization_pool.CancelAll();
+  }
+
   // Join threads
   std::mutex m;
   std::unique_lock<std::mutex> lk(m);
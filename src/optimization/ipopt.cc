@@ -16,18 +16,172 @@
 #include <IpOrigIpoptNLP.hpp>
 #include <IpTNLPAdapter.hpp>
 
-#include <csignal>    // std::sig_atomic_t
-#include <cstring>    // std::memcpy
-#include <exception>  // std::runtime_error
-#include <fstream>    // std::ofstream
-#include <iostream>   // std::cout
-#include <limits>     // std::numeric_limits
-#include <vector>     // std::vector
+#include <algorithm>           // std::max, std::min_element, std::sort
+#include <atomic>              // std::atomic
+#include <chrono>              // std::chrono
+#include <condition_variable>  // std::condition_variable
+#include <csignal>             // std::sig_atomic_t
+#include <cstring>             // std::memcpy
+#include <exception>           // std::exception_ptr, std::runtime_error
+#include <fstream>             // std::ofstream
+#include <functional>          // std::function
+#include <iostream>            // std::cout
+#include <limits>              // std::numeric_limits
+#include <memory>              // std::unique_ptr
+#include <mutex>               // std::mutex, std::unique_lock
+#include <numeric>             // std::iota
+#include <sstream>             // std::stringstream
+#include <thread>              // std::thread
+#include <vector>              // std::vector
 
 namespace {
 
 volatile std::sig_atomic_t g_runloop = true;
 
+/**
+ * Fixed set of threads that each run one partition of the work per call. The
+ * calling thread runs partition 0.
+ */
+class WorkerPool {
+
+ public:
+
+  WorkerPool(size_t num_threads);
+
+  ~WorkerPool();
+
+  size_t num_threads() const { return threads_.size() + 1; }
+
+  /**
+   * Call work(idx_partition) for every partition and wait for all of them.
+   */
+  void Run(const std::function<void(size_t)>& work);
+
+ private:
+
+  void Loop(size_t idx_thread);
+
+  std::vector<std::thread> threads_;
+
+  std::mutex mtx_;
+  std::condition_variable cv_start_;
+  std::condition_variable cv_done_;
+  const std::function<void(size_t)>* work_ = nullptr;
+  size_t generation_ = 0;
+  size_t num_running_ = 0;
+  bool is_terminating_ = false;
+
+};
+
+WorkerPool::WorkerPool(size_t num_threads) {
+  for (size_t i = 1; i < num_threads; i++) {
+    threads_.emplace_back(&WorkerPool::Loop, this, i);
+  }
+}
+
+WorkerPool::~WorkerPool() {
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    is_terminating_ = true;
+  }
+  cv_start_.notify_all();
+  for (std::thread& thread : threads_) {
+    thread.join();
+  }
+}
+
+void WorkerPool::Run(const std::function<void(size_t)>& work) {
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    work_ = &work;
+    num_running_ = threads_.size();
+    generation_++;
+  }
+  cv_start_.notify_all();
+
+  work(0);
+
+  std::unique_lock<std::mutex> lock(mtx_);
+  cv_done_.wait(lock, [this]() { return num_running_ == 0; });
+  work_ = nullptr;
+}
+
+void WorkerPool::Loop(size_t idx_thread) {
+  size_t generation = 0;
+  while (true) {
+    const std::function<void(size_t)>* work;
+    {
+      std::unique_lock<std::mutex> lock(mtx_);
+      cv_start_.wait(lock, [this, generation]() {
+        return is_terminating_ || generation_ != generation;
+      });
+      if (is_terminating_) return;
+      generation = generation_;
+      work = work_;
+    }
+
+    (*work)(idx_thread);
+
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (--num_running_ == 0) cv_done_.notify_one();
+  }
+}
+
+/**
+ * Leaf constraint with its offsets into the constraint and Jacobian vectors.
+ * MultiConstraints are flattened so that their children can be balanced
+ * independently.
+ */
+struct ConstraintTask {
+
+  ConstraintTask(logic_opt::Constraint* constraint, size_t idx_constraint, size_t idx_jacobian)
+      : constraint(constraint), idx_constraint(idx_constraint), idx_jacobian(idx_jacobian) {}
+
+  logic_opt::Constraint* constraint;
+  size_t idx_constraint;
+  size_t idx_jacobian;
+
+  // Measured wall time of the last call in seconds, or kNotMeasured
+  static constexpr double kNotMeasured = -1.;
+  double cost_evaluate = kNotMeasured;
+  double cost_jacobian = kNotMeasured;
+
+};
+
+void FlattenConstraint(logic_opt::Constraint* c, size_t idx_constraint, size_t idx_jacobian,
+                       std::vector<ConstraintTask>& tasks) {
+  const logic_opt::MultiConstraint* multi = dynamic_cast<const logic_opt::MultiConstraint*>(c);
+  if (multi == nullptr) {
+    tasks.emplace_back(c, idx_constraint, idx_jacobian);
+    return;
+  }
+  for (const std::unique_ptr<logic_opt::Constraint>& cc : *multi) {
+    FlattenConstraint(cc.get(), idx_constraint, idx_jacobian, tasks);
+    idx_constraint += cc->num_constraints();
+    idx_jacobian += cc->len_jacobian();
+  }
+}
+
+/**
+ * Assign tasks to partitions with the longest-processing-time-first rule.
+ */
+std::vector<std::vector<size_t>> PartitionTasks(const std::vector<double>& costs,
+                                                size_t num_partitions) {
+  std::vector<size_t> idx_tasks(costs.size());
+  std::iota(idx_tasks.begin(), idx_tasks.end(), 0);
+  std::sort(idx_tasks.begin(), idx_tasks.end(),
+            [&costs](size_t a, size_t b) { return costs[a] > costs[b]; });
+
+  std::vector<std::vector<size_t>> partitions(num_partitions);
+  std::vector<double> loads(num_partitions, 0.);
+  for (size_t idx_task : idx_tasks) {
+    const size_t idx_min = std::min_element(loads.begin(), loads.end()) - loads.begin();
+    partitions[idx_min].push_back(idx_task);
+    loads[idx_min] += costs[idx_task];
+  }
+  return partitions;
+}
+
 }  // namespace
 
 namespace logic_opt {
@@ -44,6 +198,7 @@ Ipopt::Ipopt(const YAML::Node& options) {
   if (options["acceptable_iter"]) options_.acceptable_iter = options["acceptable_iter"].as<size_t>();
   if (options["print_level"]) options_.print_level         = options["print_level"].as<size_t>();
   if (options["logdir"]) options_.logdir                   = options["logdir"].as<std::string>();
+  if (options["num_threads"]) options_.num_threads         = options["num_threads"].as<size_t>();
 }
 
 void Ipopt::Terminate() {
@@ -56,11 +211,16 @@ class IpoptNonlinearProgram : public ::Ipopt::TNLP {
 
   IpoptNonlinearProgram(const Variables& variables, const Objectives& objectives,
                         const Constraints& constraints, Eigen::MatrixXd& trajectory_result,
-                        Ipopt::OptimizationData* data,
-                        const std::function<void(int, const Eigen::MatrixXd&)>& iteration_callback)
+                        Optimizer::OptimizationData* data,
+                        const std::function<void(int, const Eigen::MatrixXd&)>& iteration_callback,
+                        size_t num_threads = 1)
       : variables_(variables), objectives_(objectives), constraints_(constraints),
-      trajectory_(trajectory_result), iteration_callback_(iteration_callback), data_(data) {
+      trajectory_(trajectory_result), iteration_callback_(iteration_callback),
+      data_(dynamic_cast<Ipopt::OptimizationData*>(data)),
+      is_cancelled_(data != nullptr ? data->is_cancelled : nullptr) {
     ConstructHessian();
+    ConstructThreadPool(num_threads);
+    ResetIterate();
   }
 
   virtual bool get_nlp_info(int& n, int& m, int& nnz_jac_g,
@@ -105,6 +265,26 @@ class IpoptNonlinearProgram : public ::Ipopt::TNLP {
 
   void ConstructHessian();
 
+  void ConstructThreadPool(size_t num_threads);
+
+  /**
+   * Advance the constraint iterate when Ipopt passes a new point, so that
+   * Evaluate() and Jacobian() share intermediate results at the same point.
+   */
+  void UpdateIterate(bool new_x);
+
+  /**
+   * Clear the iterate so that constraints evaluated outside of the solve
+   * recompute their intermediate results.
+   */
+  void ResetIterate();
+
+  /**
+   * Evaluate the constraints or their Jacobians on the thread pool. Partitions
+   * are rebuilt before each call from the costs measured in the previous one.
+   */
+  void EvaluateParallel(Eigen::Ref<const Eigen::MatrixXd> X, bool is_jacobian, double* output);
+
   const Variables& variables_;
   const Objectives& objectives_;
   const Constraints& constraints_;
@@ -112,6 +292,7 @@ class IpoptNonlinearProgram : public ::Ipopt::TNLP {
 
   const std::function<void(int, const Eigen::MatrixXd& X)> iteration_callback_;
   Ipopt::OptimizationData* data_;
+  const std::atomic<bool>* is_cancelled_;
   Eigen::MatrixXd& trajectory_;
 
   std::ofstream log_objective_vars_;
@@ -119,6 +300,11 @@ class IpoptNonlinearProgram : public ::Ipopt::TNLP {
   std::ofstream log_constraint_vars_;
   std::ofstream log_jacobian_vars_;
 
+  std::unique_ptr<WorkerPool> pool_;
+  std::vector<ConstraintTask> tasks_;
+
+  size_t iterate_ = Constraint::kNoIterate;
+
 };
 
 Eigen::MatrixXd Ipopt::Trajectory(const Variables& variables, const Objectives& objectives,
@@ -129,8 +315,9 @@ Eigen::MatrixXd Ipopt::Trajectory(const Variables& variables, const Objectives&
   Eigen::MatrixXd trajectory_result;
   Ipopt::OptimizationData* ipopt_data = dynamic_cast<Ipopt::OptimizationData*>(data);
   IpoptNonlinearProgram* my_nlp = new IpoptNonlinearProgram(variables, objectives, constraints,
-                                                            trajectory_result, ipopt_data,
-                                                            iteration_callback);
+                                                            trajectory_result, data,
+                                                            iteration_callback,
+                                                            options_.num_threads);
   if (!options_.logdir.empty()) {
     my_nlp->OpenLogger(options_.logdir);
   }
@@ -297,6 +484,8 @@ bool IpoptNonlinearProgram::get_starting_point(int n, bool init_x, double* x,
 
 bool IpoptNonlinearProgram::eval_f(int n, const double* x, bool new_x, double& obj_value) {
 
+  UpdateIterate(new_x);
+
   Eigen::Map<const Eigen::MatrixXd> X(x, variables_.dof, variables_.T);
 
   obj_value = 0.;
@@ -327,6 +516,8 @@ bool IpoptNonlinearProgram::eval_f(int n, const double* x, bool new_x, double& o
 
 bool IpoptNonlinearProgram::eval_grad_f(int n, const double* x, bool new_x, double* grad_f) {
 
+  UpdateIterate(new_x);
+
   Eigen::Map<const Eigen::MatrixXd> X(x, variables_.dof, variables_.T);
   Eigen::Map<Eigen::MatrixXd> Grad(grad_f, variables_.dof, variables_.T);
 
@@ -358,26 +549,32 @@ bool IpoptNonlinearProgram::eval_grad_f(int n, const double* x, bool new_x, doub
 
 bool IpoptNonlinearProgram::eval_g(int n, const double* x, bool new_x, int m, double* g) {
 
+  UpdateIterate(new_x);
+
   Eigen::Map<const Eigen::MatrixXd> X(x, variables_.dof, variables_.T);
 
-  size_t idx_constraint = 0;
-  for (const std::unique_ptr<Constraint>& c : constraints_) {
-    Eigen::Map<Eigen::VectorXd> g_c(g + idx_constraint, c->num_constraints());
-    g_c.setZero();
-    try {
-      c->Evaluate(X, g_c);
-      if ((g_c.array() != g_c.array()).any()) {
-        std::stringstream ss;
-        ss << "NaN value:" << std::endl << g_c.transpose() << std::endl
-           << "X:" << std::endl << X << std::endl;
-        throw std::runtime_error(ss.str());
+  if (pool_) {
+    EvaluateParallel(X, false, g);
+  } else {
+    size_t idx_constraint = 0;
+    for (const std::unique_ptr<Constraint>& c : constraints_) {
+      Eigen::Map<Eigen::VectorXd> g_c(g + idx_constraint, c->num_constraints());
+      g_c.setZero();
+      try {
+        c->Evaluate(X, g_c);
+        if ((g_c.array() != g_c.array()).any()) {
+          std::stringstream ss;
+          ss << "NaN value:" << std::endl << g_c.transpose() << std::endl
+             << "X:" << std::endl << X << std::endl;
+          throw std::runtime_error(ss.str());
+        }
+      } catch (const std::exception& e) {
+        std::cerr << "Constraint(" << c->name << ")::Evaluate(): " << e.what() << std::endl;
+        throw e;
       }
-    } catch (const std::exception& e) {
-      std::cerr << "Constraint(" << c->name << ")::Evaluate(): " << e.what() << std::endl;
-      throw e;
-    }
 
-    idx_constraint += c->num_constraints();
+      idx_constraint += c->num_constraints();
+    }
   }
 
   if (log_constraint_vars_.is_open()) {
@@ -394,26 +591,31 @@ bool IpoptNonlinearProgram::eval_jac_g(int n, const double* x, bool new_x,
                                   int m, int nele_jac, int* iRow, int *jCol, double* values) {
 
   if (x != nullptr) {  // values != nullptr
+    UpdateIterate(new_x);
     Eigen::Map<const Eigen::MatrixXd> X(x, variables_.dof, variables_.T);
 
-    size_t idx_jacobian = 0;
-    for (const std::unique_ptr<Constraint>& c : constraints_) {
-      Eigen::Map<Eigen::VectorXd> J_c(values + idx_jacobian, c->len_jacobian());
-      J_c.setZero();
-      try {
-        c->Jacobian(X, J_c);
-        if ((J_c.array() != J_c.array()).any()) {
-          std::stringstream ss;
-          ss << "NaN value:" << std::endl << J_c.transpose() << std::endl
-             << "X:" << std::endl << X << std::endl;
-          throw std::runtime_error(ss.str());
+    if (pool_) {
+      EvaluateParallel(X, true, values);
+    } else {
+      size_t idx_jacobian = 0;
+      for (const std::unique_ptr<Constraint>& c : constraints_) {
+        Eigen::Map<Eigen::VectorXd> J_c(values + idx_jacobian, c->len_jacobian());
+        J_c.setZero();
+        try {
+          c->Jacobian(X, J_c);
+          if ((J_c.array() != J_c.array()).any()) {
+            std::stringstream ss;
+            ss << "NaN value:" << std::endl << J_c.transpose() << std::endl
+               << "X:" << std::endl << X << std::endl;
+            throw std::runtime_error(ss.str());
+          }
+        } catch (const std::exception& e) {
+          std::cerr << "Constraint(" << c->name << ")::Jacobian(): " << e.what() << std::endl;
+          throw e;
         }
-      } catch (const std::exception& e) {
-        std::cerr << "Constraint(" << c->name << ")::Jacobian(): " << e.what() << std::endl;
-        throw e;
-      }
 
-      idx_jacobian += c->len_jacobian();
+        idx_jacobian += c->len_jacobian();
+      }
     }
 
     if (log_jacobian_vars_.is_open()) {
@@ -471,11 +673,113 @@ void IpoptNonlinearProgram::ConstructHessian() {
   H_.makeCompressed();
 }
 
+void IpoptNonlinearProgram::UpdateIterate(bool new_x) {
+  if (!new_x && iterate_ != Constraint::kNoIterate) return;
+
+  // Iterates are unique across programs so that per-thread buffers keyed on
+  // them can't be mistaken for another optimization's
+  static std::atomic<size_t> num_iterates(Constraint::kNoIterate);
+  iterate_ = ++num_iterates;
+  for (const std::unique_ptr<Constraint>& c : constraints_) {
+    c->set_iterate(iterate_);
+  }
+}
+
+void IpoptNonlinearProgram::ResetIterate() {
+  iterate_ = Constraint::kNoIterate;
+  for (const std::unique_ptr<Constraint>& c : constraints_) {
+    c->set_iterate(iterate_);
+  }
+}
+
+void IpoptNonlinearProgram::ConstructThreadPool(size_t num_threads) {
+  if (num_threads == 0) num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+  if (num_threads <= 1) return;
+
+  size_t idx_constraint = 0;
+  size_t idx_jacobian = 0;
+  for (const std::unique_ptr<Constraint>& c : constraints_) {
+    FlattenConstraint(c.get(), idx_constraint, idx_jacobian, tasks_);
+    idx_constraint += c->num_constraints();
+    idx_jacobian += c->len_jacobian();
+  }
+
+  num_threads = std::min(num_threads, tasks_.size());
+  if (num_threads <= 1) {
+    tasks_.clear();
+    return;
+  }
+  pool_ = std::make_unique<WorkerPool>(num_threads);
+}
+
+void IpoptNonlinearProgram::EvaluateParallel(Eigen::Ref<const Eigen::MatrixXd> X,
+                                             bool is_jacobian, double* output) {
+  // Estimate unmeasured tasks from their Jacobian length at the average
+  // measured time per Jacobian entry, so that all costs are in seconds
+  double time_measured = 0.;
+  size_t len_measured = 0;
+  for (const ConstraintTask& task : tasks_) {
+    const double cost = is_jacobian ? task.cost_jacobian : task.cost_evaluate;
+    if (cost == ConstraintTask::kNotMeasured) continue;
+    time_measured += cost;
+    len_measured += task.constraint->len_jacobian();
+  }
+  const double time_per_entry = len_measured > 0 ? time_measured / len_measured : 1.;
+
+  std::vector<double> costs;
+  costs.reserve(tasks_.size());
+  for (const ConstraintTask& task : tasks_) {
+    const double cost = is_jacobian ? task.cost_jacobian : task.cost_evaluate;
+    costs.push_back(cost != ConstraintTask::kNotMeasured ? cost :
+                    time_per_entry * task.constraint->len_jacobian());
+  }
+  const std::vector<std::vector<size_t>> partitions = PartitionTasks(costs, pool_->num_threads());
+
+  // Each constraint writes to its own segment of the output
+  std::vector<std::exception_ptr> errors(partitions.size());
+  pool_->Run([&](size_t idx_partition) {
+    for (size_t idx_task : partitions[idx_partition]) {
+      ConstraintTask& task = tasks_[idx_task];
+      Constraint* c = task.constraint;
+      Eigen::Map<Eigen::VectorXd> y_c(output + (is_jacobian ? task.idx_jacobian : task.idx_constraint),
+                                      is_jacobian ? c->len_jacobian() : c->num_constraints());
+      y_c.setZero();
+
+      const auto t_start = std::chrono::steady_clock::now();
+      try {
+        if (is_jacobian) {
+          c->Jacobian(X, y_c);
+        } else {
+          c->Evaluate(X, y_c);
+        }
+        if ((y_c.array() != y_c.array()).any()) {
+          std::stringstream ss;
+          ss << "NaN value:" << std::endl << y_c.transpose() << std::endl
+             << "X:" << std::endl << X << std::endl;
+          throw std::runtime_error(ss.str());
+        }
+      } catch (const std::exception& e) {
+        std::cerr << "Constraint(" << c->name << ")::" << (is_jacobian ? "Jacobian" : "Evaluate")
+                  << "(): " << e.what() << std::endl;
+        errors[idx_partition] = std::current_exception();
+        return;
+      }
+      const std::chrono::duration<double> dt = std::chrono::steady_clock::now() - t_start;
+      (is_jacobian ? task.cost_jacobian : task.cost_evaluate) = dt.count();
+    }
+  });
+
+  for (const std::exception_ptr& error : errors) {
+    if (error) std::rethrow_exception(error);
+  }
+}
+
 bool IpoptNonlinearProgram::eval_h(int n, const double* x, bool new_x, double obj_factor,
                                    int m, const double* lambda, bool new_lambda,
                                    int nele_hess, int* iRow, int* jCol, double* values) {
 
   if (x != nullptr) {  // values != nullptr
+    UpdateIterate(new_x);
     Eigen::Map<const Eigen::MatrixXd> X(x, variables_.dof, variables_.T);
     Eigen::Map<Eigen::VectorXd> H_vec(values, nele_hess);
     H_vec.setZero();
@@ -500,6 +804,8 @@ bool IpoptNonlinearProgram::eval_h(int n, const double* x, bool new_x, double ob
     for (const std::unique_ptr<Constraint>& c : constraints_) {
       Eigen::Map<const Eigen::VectorXd> Lambda(lambda + idx_constraint, c->num_constraints());
 
+      idx_constraint += c->num_constraints();
+
       // Skip Hessian computation if lambda for this constraint is 0
       if ((Lambda.array() == 0.).all()) continue;
 
@@ -509,8 +815,6 @@ bool IpoptNonlinearProgram::eval_h(int n, const double* x, bool new_x, double ob
         std::cerr << "Constraint(" << c->name << ")::Hessian(): " << e.what() << std::endl;
         throw e;
       }
-
-      idx_constraint += c->num_constraints();
     }
   }
 
@@ -555,6 +859,8 @@ void IpoptNonlinearProgram::finalize_solution(::Ipopt::SolverReturn status,
     default: str_status = "UNKNOWN"; break;
   }
 
+  ResetIterate();
+
   Eigen::Map<const Eigen::MatrixXd> X(x, variables_.dof, variables_.T);
 
   trajectory_ = X;
@@ -578,21 +884,22 @@ bool IpoptNonlinearProgram::intermediate_callback(::Ipopt::AlgorithmMode mode, i
                                                   double regularization_size, double alpha_du, double alpha_pr,
                                                   int ls_trials, const ::Ipopt::IpoptData* ip_data,
                                                   ::Ipopt::IpoptCalculatedQuantities* ip_cq) {
-  if (!iteration_callback_) return g_runloop;
+  const bool is_running = g_runloop && !(is_cancelled_ != nullptr && *is_cancelled_);
+  if (!iteration_callback_) return is_running;
 
   double* x = nullptr;
-  if (ip_cq == nullptr) return g_runloop;
+  if (ip_cq == nullptr) return is_running;
   ::Ipopt::OrigIpoptNLP* orig_nlp = dynamic_cast<::Ipopt::OrigIpoptNLP*>(GetRawPtr(ip_cq->GetIpoptNLP()));
-  if (orig_nlp == nullptr) return g_runloop;
+  if (orig_nlp == nullptr) return is_running;
 
   ::Ipopt::TNLPAdapter* tnlp_adapter = dynamic_cast<::Ipopt::TNLPAdapter*>(GetRawPtr(orig_nlp->nlp()));
-  if (tnlp_adapter == nullptr) return g_runloop;
+  if (tnlp_adapter == nullptr) return is_running;
 
   Eigen::MatrixXd X(variables_.dof, variables_.T);
   tnlp_adapter->ResortX(*ip_data->curr()->x(), X.data());
 
   iteration_callback_(iter, X);
-  return g_runloop;
+  return is_running;
 }
 
 
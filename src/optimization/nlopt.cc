@@ -11,6 +11,7 @@
 
 #include <nlopt.hpp>
 
+#include <atomic>      // std::atomic
 #include <fstream>     // std::ofstream
 #include <functional>  // std::function
 #include <iostream>    // std::cout
@@ -34,6 +35,7 @@ struct NloptNonlinearProgram {
   const Objectives& objectives;
   const Constraints& constraints;
   std::vector<Eigen::ArrayXi> constraint_gradient_map;
+  const std::atomic<bool>* is_cancelled = nullptr;
 
   struct ConstraintCache {
     Eigen::MatrixXd X;
@@ -60,6 +62,7 @@ struct NloptNonlinearProgram {
 nlopt::vfunc CompileObjectives() {
   return [](const std::vector<double>& x, std::vector<double>& grad, void* data) -> double {
     NloptNonlinearProgram& nlp = *reinterpret_cast<NloptNonlinearProgram*>(data);
+    if (nlp.is_cancelled != nullptr && *nlp.is_cancelled) throw nlopt::forced_stop();
 
     Eigen::Map<const Eigen::MatrixXd> X(&x[0], nlp.variables.dof, nlp.variables.T);
 
@@ -180,6 +183,7 @@ Eigen::MatrixXd Nlopt::Trajectory(const Variables& variables, const Objectives&
                                   const std::function<void(int, const Eigen::MatrixXd&)>& iteration_callback) {
 
   NloptNonlinearProgram nlp(variables, objectives, constraints);
+  if (data != nullptr) nlp.is_cancelled = data->is_cancelled;
   if (!options_.logdir.empty()) {
     nlp.OpenLogger(options_.logdir);
   }
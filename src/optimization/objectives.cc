@@ -9,12 +9,119 @@
 
 #include "logic_opt/optimization/objectives.h"
 
-#include <algorithm>  // std::max
+#include <algorithm>  // std::sort, std::unique
+#include <array>      // std::array
 #include <cmath>      // std::acos, std::sqrt
 #include <cassert>    // assert
+#include <optional>   // std::optional
+#include <vector>     // std::vector
 
 #include <ctrl_utils/euclidian.h>
 #include <ctrl_utils/math.h>
+#include <unsupported/Eigen/AutoDiff>
+
+namespace {
+
+// Nested forward-mode scalar for second derivatives
+using AutoDiff = Eigen::AutoDiffScalar<Eigen::VectorXd>;
+using AutoDiff2 = Eigen::AutoDiffScalar<Eigen::Matrix<AutoDiff, Eigen::Dynamic, 1>>;
+
+template<int Dim>
+using MatrixAutoDiff2 = typename logic_opt::World<Dim>::template MatrixT<AutoDiff2>;
+
+/**
+ * Sorted variables that move the frame at timestep t or t+1.
+ */
+template<int Dim>
+std::vector<size_t> VelocityVariables(const logic_opt::World<Dim>& world,
+                                      const std::string& name_frame, size_t t) {
+  std::vector<size_t> idx_vars;
+  for (size_t tt = t; tt <= t + 1; tt++) {
+    for (const auto& key_val : world.frames(tt).ancestors(name_frame)) {
+      const logic_opt::Frame& frame = key_val.second;
+      if (frame.is_variable()) idx_vars.push_back(frame.idx_var());
+    }
+  }
+  std::sort(idx_vars.begin(), idx_vars.end());
+  idx_vars.erase(std::unique(idx_vars.begin(), idx_vars.end()), idx_vars.end());
+  return idx_vars;
+}
+
+/**
+ * Seed the columns idx_vars of X_ad with first and second derivatives, or
+ * reset them to constants if is_seeded is false.
+ */
+template<int Dim>
+void SeedHessian(Eigen::Ref<const Eigen::MatrixXd> X, const std::vector<size_t>& idx_vars,
+                 bool is_seeded, MatrixAutoDiff2<Dim>& X_ad) {
+  const size_t dof = X.rows();
+  const size_t n = dof * idx_vars.size();
+  for (size_t k = 0; k < idx_vars.size(); k++) {
+    for (size_t i = 0; i < dof; i++) {
+      const double x = X(i, idx_vars[k]);
+      AutoDiff2& x_ad = X_ad(i, idx_vars[k]);
+      if (!is_seeded) {
+        x_ad = AutoDiff2(x);
+        continue;
+      }
+      const size_t j = dof * k + i;
+      x_ad.value() = AutoDiff(x, n, j);
+      x_ad.derivatives() = Eigen::Matrix<AutoDiff, Eigen::Dynamic, 1>::Unit(n, j);
+      for (size_t jj = 0; jj < n; jj++) {
+        x_ad.derivatives()(jj).derivatives() = Eigen::VectorXd::Zero(n);
+      }
+    }
+  }
+}
+
+/**
+ * Add coeff times the Hessian of f with respect to the seeded variables to
+ * the lower triangle of Hessian.
+ */
+void AddHessian(const AutoDiff2& f, const std::vector<size_t>& idx_vars, size_t dof,
+                double coeff, Eigen::Ref<Eigen::SparseMatrix<double>> Hessian) {
+  const size_t n = f.derivatives().size();
+  for (size_t a = 0; a < n; a++) {
+    const Eigen::VectorXd& d2f_da = f.derivatives()(a).derivatives();
+    if (d2f_da.size() == 0) continue;
+    const size_t row = dof * idx_vars[a / dof] + a % dof;
+    for (size_t b = 0; b < n; b++) {
+      const size_t col = dof * idx_vars[b / dof] + b % dof;
+      if (col > row) continue;
+      Hessian.coeffRef(row, col) += coeff * d2f_da(b);
+    }
+  }
+}
+
+/**
+ * Lower triangle of the dense block between the variables idx_vars.
+ */
+void AddHessianStructure(const std::vector<size_t>& idx_vars, size_t dof,
+                         Eigen::SparseMatrix<bool>& Hessian) {
+  for (size_t var_a : idx_vars) {
+    for (size_t var_b : idx_vars) {
+      if (var_b > var_a) continue;
+      for (size_t i = 0; i < dof; i++) {
+        for (size_t j = 0; j < dof; j++) {
+          if (var_b == var_a && j > i) continue;
+          Hessian.coeffRef(dof * var_a + i, dof * var_b + j) = true;
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Frame ids from id_frame up to the root, inclusive.
+ */
+void AncestorIds(const logic_opt::FrameTree& frames, size_t id_frame, std::vector<size_t>& ids) {
+  ids.clear();
+  for (int id = id_frame; id != logic_opt::FrameTree::kNoParent; id = frames.parent(id)) {
+    ids.push_back(id);
+  }
+}
+
+}  // namespace
 
 namespace logic_opt {
 
@@ -54,6 +161,27 @@ void MinL2NormObjective::Gradient(Eigen::Ref<const Eigen::MatrixXd> X,
   Objective::Gradient(X, Gradient);
 }
 
+void MinL2NormObjective::Hessian(Eigen::Ref<const Eigen::MatrixXd> X, double sigma,
+                                 Eigen::Ref<Eigen::SparseMatrix<double>> Hessian) {
+  // d^2/dx^2 0.5 * coeff * x^2 = coeff
+  for (size_t t = 0; t < X.cols(); t++) {
+    const size_t var_t = X.rows() * t + row_start_;
+    for (size_t i = 0; i < num_rows_; i++) {
+      Hessian.coeffRef(var_t + i, var_t + i) += sigma * coeff_;
+    }
+  }
+}
+
+void MinL2NormObjective::HessianStructure(Eigen::SparseMatrix<bool>& Hessian, size_t T) {
+  const size_t dof = Hessian.rows() / T;
+  for (size_t t = 0; t < T; t++) {
+    const size_t var_t = dof * t + row_start_;
+    for (size_t i = 0; i < num_rows_; i++) {
+      Hessian.coeffRef(var_t + i, var_t + i) = true;
+    }
+  }
+}
+
 void MinL1NormObjective::Evaluate(Eigen::Ref<const Eigen::MatrixXd> X, double& objective) {
   if (X.cols() != X_0.cols() && X_0.cols() == 1) {
     const Eigen::VectorXd x_0 = X_0;
@@ -101,94 +229,178 @@ void LinearVelocityObjective<2>::Evaluate(Eigen::Ref<const Eigen::MatrixXd> X, d
   Objective::Evaluate(X, objective);
 }
 
-Eigen::Matrix3Xd PositionJacobian(const logic_opt::World3& world, const std::string& name_frame,
-                                  Eigen::Ref<const Eigen::MatrixXd> X, size_t t) {
-  Eigen::Matrix3Xd J_t = Eigen::Matrix3Xd::Zero(3, X.size());
+/**
+ * Nonzero kDof-column block of a frame position Jacobian, with respect to the
+ * variable column idx_var of X.
+ */
+template<int Dim>
+struct PositionJacobianBlock {
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
 
-  auto chain = world.frames(t).ancestors(name_frame);
-  for (auto it = chain.begin(); it != chain.end(); ++it) {
-    if (it->first == world.kWorldFrame) break;
-    const Frame& frame = it->second;
-    if (!frame.is_variable()) continue;
+  int idx_var;
+  Eigen::Matrix<double, Dim, World<Dim>::kDof> J;
+};
 
-    auto J_pos = J_t.block<3,3>(0, 6 * frame.idx_var());
-    const std::string& name_parent = *world.frames(t).parent(frame.name());
-    J_pos = world.Orientation(name_parent, world.kWorldFrame, X, t);
+/**
+ * Position Jacobian stored as one block per variable ancestor of the frame.
+ */
+template<int Dim>
+using PositionJacobianBlocks = std::vector<PositionJacobianBlock<Dim>,
+                                           Eigen::aligned_allocator<PositionJacobianBlock<Dim>>>;
 
-    if (frame.name() == name_frame) continue;
-    auto J_ori = J_t.block<3,3>(0, 6 * frame.idx_var() + 3);
-    const Eigen::Vector3d p = world.Position(name_frame, frame.name(), X, t);
-    const auto x_r = X.block<3,1>(3, frame.idx_var());
-    const Eigen::AngleAxisd aa(x_r.norm(), x_r.normalized());
-    J_ori = J_pos * ctrl_utils::ExpMapJacobian(aa, p);
-  }
-  return J_t;
+/**
+ * Derivative of the frame position with respect to the exp coordinates of
+ * the variable frame, given the position p of the frame in the variable frame.
+ */
+Eigen::Matrix3d PositionJacobianOrientation(Eigen::Ref<const Eigen::MatrixXd> X, int idx_var,
+                                            const Eigen::Vector3d& p) {
+  const auto x_r = X.block<3,1>(3, idx_var);
+  const Eigen::AngleAxisd aa(x_r.norm(), x_r.normalized());
+  return ctrl_utils::ExpMapJacobian(aa, p);
 }
 
-Eigen::Matrix2Xd PositionJacobian(const logic_opt::World2& world, const std::string& name_frame,
-                                  Eigen::Ref<const Eigen::MatrixXd> X, size_t t) {
-  Eigen::Matrix2Xd J_t = Eigen::Matrix2Xd::Zero(2, X.size());
-
-  auto chain = world.frames(t).ancestors(name_frame);
-  for (auto it = chain.begin(); it != chain.end(); ++it) {
-    if (it->first == world.kWorldFrame) break;
-    const Frame& frame = it->second;
-    if (!frame.is_variable()) continue;
+Eigen::Vector2d PositionJacobianOrientation(Eigen::Ref<const Eigen::MatrixXd> X, int idx_var,
+                                            const Eigen::Vector2d& p) {
+  // d/dtheta R(theta) p = R(theta + pi/2) p
+  const Eigen::Vector2d R_p = Eigen::Rotation2Dd(X(2, idx_var)) * p;
+  return Eigen::Vector2d(-R_p(1), R_p(0));
+}
 
-    auto J_pos = J_t.block<2,2>(0, 3 * frame.idx_var());
-    const std::string& name_parent = *world.frames(t).parent(frame.name());
-    J_pos = world.Orientation(name_parent, world.kWorldFrame, X, t);
+template<int Dim>
+void PositionJacobian(const World<Dim>& world, const std::string& name_frame,
+                      Eigen::Ref<const Eigen::MatrixXd> X, size_t t,
+                      PositionJacobianBlocks<Dim>& J_t) {
+  J_t.clear();
+
+  const FrameTree frames = world.frames(t);
+  const size_t id_frame = world.FrameId(name_frame);
+  for (int id = id_frame; frames.parent(id) != FrameTree::kNoParent; id = frames.parent(id)) {
+    const int idx_var = frames.idx_var(id);
+    if (idx_var < 0) continue;
+
+    J_t.emplace_back();
+    PositionJacobianBlock<Dim>& block = J_t.back();
+    block.idx_var = idx_var;
+
+    const std::string& name_parent = frames.name(frames.parent(id));
+    auto J_pos = block.J.template leftCols<Dim>();
+    J_pos = world.T_to_world(name_parent, X, t).linear();
+
+    auto J_ori = block.J.template rightCols<World<Dim>::kDof - Dim>();
+    if (id == id_frame) {
+      J_ori.setZero();
+      continue;
+    }
+    const Eigen::Vectord<Dim> p = world.Position(name_frame, frames.name(id), X, t);
+    J_ori = J_pos * PositionJacobianOrientation(X, idx_var, p);
+  }
+}
 
-    if (frame.name() == name_frame) continue;
-    auto J_ori = J_t.block<2,1>(0, 3 * frame.idx_var() + 2);
-    const Eigen::Vector2d p = world.Position(name_frame, frame.name(), X, t);
-    J_ori = J_pos * Eigen::Vector2d(-p(1), p(0));
+/**
+ * Gradient += coeff * J_t^T * v, touching only the columns of J_t's blocks.
+ */
+template<int Dim>
+void AddPositionJacobianTranspose(const PositionJacobianBlocks<Dim>& J_t,
+                                  const Eigen::Vectord<Dim>& v, double coeff,
+                                  Eigen::Ref<Eigen::MatrixXd> Gradient) {
+  for (const PositionJacobianBlock<Dim>& block : J_t) {
+    Gradient.col(block.idx_var) += coeff * block.J.transpose() * v;
   }
-  return J_t;
 }
 
 template<int Dim>
-inline Eigen::MatrixXd LinearVelocityObjectiveGradient(Eigen::Ref<const Eigen::MatrixXd> X,
-                                                       const World<Dim>& world,
-                                                       const std::string& name_ee) {
-  Eigen::MatrixXd Gradient = Eigen::MatrixXd::Zero(world.kDof, world.num_timesteps());
+inline void LinearVelocityObjectiveGradient(Eigen::Ref<const Eigen::MatrixXd> X,
+                                            const World<Dim>& world,
+                                            const std::string& name_ee, double coeff,
+                                            Eigen::Ref<Eigen::MatrixXd> Gradient) {
+  PositionJacobianBlocks<Dim> J_t;
   Eigen::Vectord<Dim> dx_prev = Eigen::Vectord<Dim>::Zero();
-  Eigen::Map<Eigen::VectorXd> gradient(Gradient.data(), Gradient.size());
 
   Eigen::Vectord<Dim> x_t = world.Position(name_ee, world.kWorldFrame, X, 0);
   for (size_t t = 0; t < X.cols() - 1; t++) {
-    const auto J_t = PositionJacobian(world, name_ee, X, t);
+    PositionJacobian(world, name_ee, X, t, J_t);
 
     const auto x_next = world.Position(name_ee, world.kWorldFrame, X, t+1);
     const Eigen::Vectord<Dim> dx_t = x_next - x_t;
 
     // J_{:,t} = J_t^T * ((x_{t} - x_{t-1}) - (x_{t+1} - x_{t}))
-    gradient += J_t.transpose() * (dx_prev - dx_t);
+    AddPositionJacobianTranspose<Dim>(J_t, dx_prev - dx_t, coeff, Gradient);
 
     x_t = x_next;
     dx_prev = dx_t;
   }
 
   // J_{:,T} = J_T^T * ((x_{T} - x_{T-1})
-  const auto J_T = PositionJacobian(world, name_ee, X, X.cols() - 1);
-  gradient += J_T.transpose() * dx_prev;
-  return Gradient;
+  PositionJacobian(world, name_ee, X, X.cols() - 1, J_t);
+  AddPositionJacobianTranspose<Dim>(J_t, dx_prev, coeff, Gradient);
 }
 
 template<>
 void LinearVelocityObjective<3>::Gradient(Eigen::Ref<const Eigen::MatrixXd> X,
                                           Eigen::Ref<Eigen::MatrixXd> Gradient) {
-  Gradient += coeff_ * LinearVelocityObjectiveGradient<3>(X, world_, name_ee_);
+  LinearVelocityObjectiveGradient<3>(X, world_, name_ee_, coeff_, Gradient);
   Objective::Gradient(X, Gradient);
 }
 
 template<>
 void LinearVelocityObjective<2>::Gradient(Eigen::Ref<const Eigen::MatrixXd> X,
                                           Eigen::Ref<Eigen::MatrixXd> Gradient) {
-  Gradient += coeff_ * LinearVelocityObjectiveGradient<2>(X, world_, name_ee_);
+  LinearVelocityObjectiveGradient<2>(X, world_, name_ee_, coeff_, Gradient);
   Objective::Gradient(X, Gradient);
 }
 
+template<int Dim>
+inline void LinearVelocityObjectiveHessian(Eigen::Ref<const Eigen::MatrixXd> X,
+                                           const World<Dim>& world, const std::string& name_ee,
+                                           double coeff,
+                                           Eigen::Ref<Eigen::SparseMatrix<double>> Hessian) {
+  MatrixAutoDiff2<Dim> X_ad = X.cast<AutoDiff2>();
+  for (size_t t = 0; t < X.cols() - 1; t++) {
+    const std::vector<size_t> idx_vars = VelocityVariables(world, name_ee, t);
+    if (idx_vars.empty()) continue;
+
+    // d^2/dX^2 0.5 * || x_{t+1} - x_{t} ||^2
+    SeedHessian<Dim>(X, idx_vars, true, X_ad);
+    const Eigen::Matrix<AutoDiff2, Dim, 1> dx_t =
+        world.Position(name_ee, world.kWorldFrame, X_ad, t+1) -
+        world.Position(name_ee, world.kWorldFrame, X_ad, t);
+    const AutoDiff2 objective = 0.5 * dx_t.squaredNorm();
+    AddHessian(objective, idx_vars, world.kDof, coeff, Hessian);
+    SeedHessian<Dim>(X, idx_vars, false, X_ad);
+  }
+}
+
+template<int Dim>
+inline void LinearVelocityObjectiveHessianStructure(const World<Dim>& world,
+                                                    const std::string& name_ee, size_t T,
+                                                    Eigen::SparseMatrix<bool>& Hessian) {
+  for (size_t t = 0; t < T - 1; t++) {
+    AddHessianStructure(VelocityVariables(world, name_ee, t), world.kDof, Hessian);
+  }
+}
+
+template<>
+void LinearVelocityObjective<3>::Hessian(Eigen::Ref<const Eigen::MatrixXd> X, double sigma,
+                                         Eigen::Ref<Eigen::SparseMatrix<double>> Hessian) {
+  LinearVelocityObjectiveHessian<3>(X, world_, name_ee_, sigma * coeff_, Hessian);
+}
+
+template<>
+void LinearVelocityObjective<2>::Hessian(Eigen::Ref<const Eigen::MatrixXd> X, double sigma,
+                                         Eigen::Ref<Eigen::SparseMatrix<double>> Hessian) {
+  LinearVelocityObjectiveHessian<2>(X, world_, name_ee_, sigma * coeff_, Hessian);
+}
+
+template<>
+void LinearVelocityObjective<3>::HessianStructure(Eigen::SparseMatrix<bool>& Hessian, size_t T) {
+  LinearVelocityObjectiveHessianStructure<3>(world_, name_ee_, T, Hessian);
+}
+
+template<>
+void LinearVelocityObjective<2>::HessianStructure(Eigen::SparseMatrix<bool>& Hessian, size_t T) {
+  LinearVelocityObjectiveHessianStructure<2>(world_, name_ee_, T, Hessian);
+}
+
 void AngularVelocityObjective::Evaluate(Eigen::Ref<const Eigen::MatrixXd> X, double& objective) {
   Eigen::Quaterniond quat_t(world_.Orientation(name_ee_, world_.kWorldFrame, X, 0));
   for (size_t t = 0; t < X.cols() - 1; t++) {
@@ -203,67 +415,6 @@ void AngularVelocityObjective::Evaluate(Eigen::Ref<const Eigen::MatrixXd> X, dou
   Objective::Evaluate(X, objective);
 }
 
-std::array<std::optional<Eigen::Matrix3d>, 3> RotationChain(const logic_opt::World3& world,
-                                                            const std::string& name_frame,
-                                                            size_t idx_var,
-                                                            Eigen::Ref<const Eigen::MatrixXd> X,
-                                                            size_t t1, size_t t2) {
-  // Matrix tuple (A, X_inv, B, X, C)
-  std::array<std::optional<Eigen::Matrix3d>, 3> Rs;
-
-  // Get ancestor chains from ee to world at t1 and t2
-  std::vector<const std::pair<const std::string, Frame>*> chain1;
-  std::vector<const std::pair<const std::string, Frame>*> chain2;
-  auto ancestors1 = world.frames(t1).ancestors(name_frame);
-  auto ancestors2 = world.frames(t2).ancestors(name_frame);
-  for (auto it = ancestors1.begin(); it != ancestors1.end(); ++it) {
-    chain1.push_back(&*it);
-  }
-  for (auto it = ancestors2.begin(); it != ancestors2.end(); ++it) {
-    chain2.push_back(&*it);
-  }
-
-  // Find closest common ancestor between ee frames at t1 and t2
-  int idx_end1 = chain1.size() - 1;
-  int idx_end2 = chain2.size() - 1;
-  while (idx_end1 >= 0 && idx_end2 >= 0 && chain1[idx_end1]->second == chain2[idx_end2]->second) {
-    --idx_end1;
-    --idx_end2;
-  }
-
-  // Construct A?
-  Eigen::Matrix3d R = Eigen::Matrix3d::Identity();
-  for (size_t i = 0; i <= idx_end1; i++) {
-    const Frame& frame = chain1[i]->second;
-    if (frame.idx_var() == idx_var && frame.is_variable()) {
-      Rs[0] = R.transpose();
-      R.setIdentity();
-      continue;
-    }
-    R = world.T_to_parent(frame.name(), X, t1).linear() * R;
-  }
-
-  // Construct B, C?
-  Rs[1] = R.transpose();
-  size_t idx = 1;
-  R.setIdentity();
-  for (int i = idx_end2; i >= 0; i--) {
-    const Frame& frame = chain2[i]->second;
-    if (frame.idx_var() == idx_var && frame.is_variable()) {
-      Rs[1] = *Rs[1] * R;
-      R.setIdentity();
-      idx = 2;
-      continue;
-    }
-    R = R * world.T_to_parent(frame.name(), X, t2).linear();
-  }
-
-  // Finish B or C
-  Rs[idx] = (idx == 2) ? R : *Rs[idx] * R;
-
-  return Rs;
-}
-
 void ComputeOrientationTrace(const Eigen::Matrix3d& R,
                              const std::array<std::optional<Eigen::Matrix3d>, 3>& Rs,
                              Eigen::Matrix3d* Phi, Eigen::Matrix3d* dTrPhi_dR) {
@@ -320,26 +471,110 @@ Eigen::Vector3d NormLogExpCoordsGradient(const Eigen::Matrix3d& Phi,
 
 void AngularVelocityObjective::Gradient(Eigen::Ref<const Eigen::MatrixXd> X,
                                         Eigen::Ref<Eigen::MatrixXd> Gradient) {
+  // Exp map rotations and Jacobians of the variables, computed on first use
+  std::vector<Eigen::Matrix3d> R_vars(X.cols());
+  std::vector<Eigen::Matrix<double,9,3>> dR_dw_vars(X.cols());
+  std::vector<bool> is_computed(X.cols(), false);
+  const auto AddGradient = [&](const std::array<std::optional<Eigen::Matrix3d>, 3>& Rs,
+                               int idx_var) {
+    if (!is_computed[idx_var]) {
+      const auto x_r = X.col(idx_var).tail<3>();
+      const Eigen::AngleAxisd aa(x_r.norm(), x_r.normalized());
+      R_vars[idx_var] = ctrl_utils::Exp(x_r);
+      dR_dw_vars[idx_var] = ctrl_utils::ExpMapJacobian(aa);
+      is_computed[idx_var] = true;
+    }
 
-  for (int idx_var = 0; idx_var < X.cols(); idx_var++) {
-    const auto x_r = X.col(idx_var).tail<3>();
-    const Eigen::AngleAxisd aa(x_r.norm(), x_r.normalized());
-    const Eigen::Matrix3d R = ctrl_utils::Exp(x_r);
-    const Eigen::Matrix<double,9,3> dR_dw = ctrl_utils::ExpMapJacobian(aa);
+    Eigen::Matrix3d Phi;
+    Eigen::Matrix3d dTrPhi_dR;
+    ComputeOrientationTrace(R_vars[idx_var], Rs, &Phi, &dTrPhi_dR);
+
+    const Eigen::Vector3d g = NormLogExpCoordsGradient(Phi, dR_dw_vars[idx_var], dTrPhi_dR);
+    Gradient.block<3,1>(3, idx_var) += coeff_ * g;
+  };
+
+  // Each term only depends on the variables between the ee and the closest
+  // common ancestor of its frames at t and t+1, so the world orientations of
+  // the frames on those chains are enough to split R_{t}^{-1} R_{t+1} around
+  // each variable.
+  const size_t id_ee = world_.FrameId(name_ee_);
+  std::vector<size_t> chain1;
+  std::vector<size_t> chain2;
+  for (size_t t = 0; t < X.cols() - 1; t++) {
+    const FrameTree frames1 = world_.frames(t);
+    const FrameTree frames2 = world_.frames(t+1);
+    AncestorIds(frames1, id_ee, chain1);
+    AncestorIds(frames2, id_ee, chain2);
+    while (!chain1.empty() && !chain2.empty() && chain1.back() == chain2.back() &&
+           frames1.idx_var(chain1.back()) == frames2.idx_var(chain2.back())) {
+      chain1.pop_back();
+      chain2.pop_back();
+    }
+    if (chain1.empty() && chain2.empty()) continue;
+
+    const Eigen::Matrix3d R1 = world_.T_to_world(name_ee_, X, t).linear();
+    const Eigen::Matrix3d R2 = world_.T_to_world(name_ee_, X, t+1).linear();
+    if (3. - (R1.transpose() * R2).trace() < 1e-3) continue;  // Identity
+
+    // Variables at t: R_{t}^{-1} R_{t+1} = A R^{-1} B
+    for (size_t id : chain1) {
+      const int idx_var = frames1.idx_var(id);
+      if (idx_var < 0) continue;
+      std::array<std::optional<Eigen::Matrix3d>, 3> Rs;
+      Rs[0] = R1.transpose() * world_.T_to_world(frames1.name(id), X, t).linear();
+      Rs[1] = world_.T_to_world(frames1.name(frames1.parent(id)), X, t).linear().transpose() * R2;
+      AddGradient(Rs, idx_var);
+    }
 
-    for (size_t t = std::max(0, idx_var - 1); t < X.cols() - 1; t++) {
-      const std::array<std::optional<Eigen::Matrix3d>, 3> Rs = RotationChain(world_, name_ee_, idx_var, X, t, t+1);
-      if (!Rs[0] && !Rs[2]) continue;
+    // Variables at t+1: R_{t}^{-1} R_{t+1} = B R C
+    for (size_t id : chain2) {
+      const int idx_var = frames2.idx_var(id);
+      if (idx_var < 0) continue;
+      std::array<std::optional<Eigen::Matrix3d>, 3> Rs;
+      Rs[1] = R1.transpose() * world_.T_to_world(frames2.name(frames2.parent(id)), X, t+1).linear();
+      Rs[2] = world_.T_to_world(frames2.name(id), X, t+1).linear().transpose() * R2;
+      AddGradient(Rs, idx_var);
+    }
+  }
+  Objective::Gradient(X, Gradient);
+}
 
-      Eigen::Matrix3d Phi;
-      Eigen::Matrix3d dTrPhi_dR;
-      ComputeOrientationTrace(R, Rs, &Phi, &dTrPhi_dR);
+void AngularVelocityObjective::Hessian(Eigen::Ref<const Eigen::MatrixXd> X, double sigma,
+                                       Eigen::Ref<Eigen::SparseMatrix<double>> Hessian) {
+  using std::acos;
 
-      const Eigen::Vector3d g = NormLogExpCoordsGradient(Phi, dR_dw, dTrPhi_dR);
-      Gradient.block<3,1>(3, idx_var) += coeff_ * g;
+  MatrixAutoDiff2<3> X_ad = X.cast<AutoDiff2>();
+  for (size_t t = 0; t < X.cols() - 1; t++) {
+    const std::vector<size_t> idx_vars = VelocityVariables(world_, name_ee_, t);
+    if (idx_vars.empty()) continue;
+
+    // 0.5 * || log(R_{t}^{-1} R_{t+1}) ||^2 = 0.5 * theta^2
+    SeedHessian<3>(X, idx_vars, true, X_ad);
+    const Eigen::Matrix<AutoDiff2, 3, 3> Phi =
+        world_.Orientation(name_ee_, world_.kWorldFrame, X_ad, t).transpose() *
+        world_.Orientation(name_ee_, world_.kWorldFrame, X_ad, t+1);
+    const AutoDiff2 u = 1. - 0.5 * (Phi.trace() - 1.);  // 1 - cos(theta)
+    SeedHessian<3>(X, idx_vars, false, X_ad);
+
+    // The log is not differentiable at rotations by pi
+    if (u.value().value() > 2. - 1e-6) continue;
+
+    // Expand acos(1 - u)^2 near the identity, where acos is singular
+    AutoDiff2 theta_sq;
+    if (u.value().value() < 1e-6) {
+      theta_sq = u * (2. + u * (1. / 3. + u * (4. / 45.)));
+    } else {
+      const AutoDiff2 theta = acos(1. - u);
+      theta_sq = theta * theta;
     }
+    AddHessian(0.5 * theta_sq, idx_vars, world_.kDof, sigma * coeff_, Hessian);
+  }
+}
+
+void AngularVelocityObjective::HessianStructure(Eigen::SparseMatrix<bool>& Hessian, size_t T) {
+  for (size_t t = 0; t < T - 1; t++) {
+    AddHessianStructure(VelocityVariables(world_, name_ee_, t), world_.kDof, Hessian);
   }
-  Objective::Gradient(X, Gradient);
 }
 
 void WorkspaceObjective::Evaluate(Eigen::Ref<const Eigen::MatrixXd> X, double& objective) {
@@ -358,18 +593,18 @@ void WorkspaceObjective::Evaluate(Eigen::Ref<const Eigen::MatrixXd> X, double& o
 
 void WorkspaceObjective::Gradient(Eigen::Ref<const Eigen::MatrixXd> X,
                                   Eigen::Ref<Eigen::MatrixXd> Gradient) {
-  Eigen::Map<Eigen::VectorXd> gradient(Gradient.data(), Gradient.size());
+  PositionJacobianBlocks<3> J_t;
   for (size_t t = 0; t < X.cols(); t++) {
     const Eigen::Vector3d x_t = world_.Position(name_ee_, world_.kWorldFrame, X, t);
     const double radius = x_t.norm();
     if (radius > kWorkspaceRadius) {
-      const auto J_t = PositionJacobian(world_, name_ee_, X, t);
-      gradient += coeff_ * std::exp(radius - kWorkspaceRadius) *
-                  J_t.transpose() * x_t.normalized();
+      PositionJacobian(world_, name_ee_, X, t, J_t);
+      AddPositionJacobianTranspose<3>(J_t, x_t.normalized(),
+                                      coeff_ * std::exp(radius - kWorkspaceRadius), Gradient);
     } else if (radius < kBaseRadius) {
-      const auto J_t = PositionJacobian(world_, name_ee_, X, t);
-      gradient += coeff_ * std::exp(kBaseRadius - radius) *
-                  J_t.transpose() * x_t.normalized();
+      PositionJacobian(world_, name_ee_, X, t, J_t);
+      AddPositionJacobianTranspose<3>(J_t, x_t.normalized(),
+                                      coeff_ * std::exp(kBaseRadius - radius), Gradient);
     }
     if (radius <= kWorkspaceRadius) continue;
 
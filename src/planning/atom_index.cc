@@ -0,0 +1,135 @@
+/**
+ * atom_index.cc
+ *
+ * Copyright 2026. All Rights Reserved.
+ *
+ * Created: October 17, 2026
+ * Authors: Toki Migimatsu
+ */
+
+#include "logic_opt/planning/atom_index.h"
+
+#include <numeric>    // std::iota
+#include <sstream>    // std::stringstream
+#include <stdexcept>  // std::invalid_argument
+
+namespace logic_opt {
+
+namespace {
+
+const std::vector<const VAL::parameter_symbol*>& TypeObjects(const ObjectTypeMap& objects,
+                                                             const VAL::pddl_type* type) {
+  static const std::vector<const VAL::parameter_symbol*> kEmpty;
+  auto it = objects.find(type);
+  return it == objects.end() ? kEmpty : it->second;
+}
+
+}  // namespace
+
+constexpr size_t AtomIndex::kNotFound;
+
+AtomIndex::AtomIndex(const VAL::domain* domain, const std::shared_ptr<const ObjectTypeMap>& objects)
+    : objects_(objects) {
+
+  // Assign dense ids to objects (objects appear once per supertype)
+  for (const auto& key_val : *objects_) {
+    for (const VAL::parameter_symbol* object : key_val.second) {
+      idx_objects_.emplace(object, idx_objects_.size());
+    }
+  }
+
+  // Sort predicates by name so atom ids follow Proposition ordering
+  std::map<std::string, const VAL::pred_decl*> pred_decls;
+  if (domain->predicates != nullptr) {
+    for (const VAL::pred_decl* pred : *domain->predicates) {
+      pred_decls[pred->getPred()->getName()] = pred;
+    }
+  }
+
+  size_t num_atoms = 0;
+  for (const auto& key_val : pred_decls) {
+    Predicate pred;
+    pred.name = key_val.first;
+    pred.offset = num_atoms;
+
+    // Compute place values from the last argument backwards
+    std::vector<const std::vector<const VAL::parameter_symbol*>*> arg_objects;
+    for (const VAL::parameter_symbol* param : *key_val.second->getArgs()) {
+      arg_objects.push_back(&TypeObjects(*objects_, param->type));
+    }
+    pred.strides.resize(arg_objects.size());
+    size_t num_pred_atoms = 1;
+    for (size_t i = arg_objects.size(); i > 0; i--) {
+      pred.strides[i - 1] = num_pred_atoms;
+      num_pred_atoms *= arg_objects[i - 1]->size();
+    }
+
+    // Map object ids to their positions in each argument's type
+    pred.idx_objects.reserve(arg_objects.size());
+    for (const std::vector<const VAL::parameter_symbol*>* type_objects : arg_objects) {
+      std::vector<size_t> idx_objects(idx_objects_.size(), kNotFound);
+      for (size_t i = 0; i < type_objects->size(); i++) {
+        idx_objects[idx_objects_.at((*type_objects)[i])] = i;
+      }
+      pred.idx_objects.push_back(std::move(idx_objects));
+    }
+
+    // Decode atoms
+    for (size_t idx = 0; idx < num_pred_atoms; idx++) {
+      std::vector<const VAL::parameter_symbol*> args;
+      args.reserve(arg_objects.size());
+      for (size_t i = 0; i < arg_objects.size(); i++) {
+        args.push_back((*arg_objects[i])[(idx / pred.strides[i]) % arg_objects[i]->size()]);
+      }
+      atoms_.emplace_back(pred.name, std::move(args));
+    }
+    num_atoms += num_pred_atoms;
+
+    idx_predicates_[pred.name] = predicates_.size();
+    predicates_.push_back(std::move(pred));
+  }
+}
+
+size_t AtomIndex::PredicateIndex(const std::string& name_predicate) const {
+  auto it = idx_predicates_.find(name_predicate);
+  return it == idx_predicates_.end() ? kNotFound : it->second;
+}
+
+size_t AtomIndex::AtomId(size_t idx_predicate,
+                         const std::vector<const VAL::parameter_symbol*>& args) const {
+  if (args.size() != predicates_[idx_predicate].strides.size()) return kNotFound;
+  std::vector<size_t> idx_args(args.size());
+  std::iota(idx_args.begin(), idx_args.end(), 0);
+  return AtomId(idx_predicate, args, idx_args);
+}
+
+size_t AtomIndex::AtomId(const Proposition& P) const {
+  const size_t idx_predicate = PredicateIndex(P.predicate());
+  if (idx_predicate == kNotFound) return kNotFound;
+  return AtomId(idx_predicate, P.variables());
+}
+
+State AtomIndex::CreateState(const std::set<Proposition>& propositions) const {
+  State state = CreateState();
+  for (const Proposition& P : propositions) {
+    if (P.predicate() == "=") continue;
+    const size_t idx_atom = AtomId(P);
+    if (idx_atom == kNotFound) {
+      std::stringstream ss;
+      ss << "AtomIndex::CreateState(): " << P << " is not a valid atom.";
+      throw std::invalid_argument(ss.str());
+    }
+    state.Add(idx_atom);
+  }
+  return state;
+}
+
+std::set<Proposition> AtomIndex::CreatePropositions(const State& state) const {
+  std::set<Proposition> propositions;
+  for (size_t i = 0; i < atoms_.size(); i++) {
+    if (state.Contains(i)) propositions.insert(atoms_[i]);
+  }
+  return propositions;
+}
+
+}  // namespace logic_opt
@@ -0,0 +1,344 @@
+/**
+ * formula.cc
+ *
+ * Copyright 2026. All Rights Reserved.
+ *
+ * Created: October 17, 2026
+ * Authors: Toki Migimatsu
+ */
+
+#include "logic_opt/planning/formula.h"
+
+#include <algorithm>  // std::all_of, std::copy
+#include <array>      // std::array
+#include <iterator>   // std::next
+#include <stdexcept>  // std::runtime_error
+#include <string>     // std::string
+
+#include "logic_opt/planning/parameter_generator.h"
+
+namespace logic_opt {
+
+constexpr size_t Formula::kNumStackSlots;
+constexpr size_t Formula::kMaxExpandedInstructions;
+
+class Formula::Compiler {
+
+ public:
+
+  Compiler(Formula* formula, const std::vector<const VAL::parameter_symbol*>& params)
+      : formula_(*formula), atoms_(*formula->atoms_) {
+    for (const VAL::parameter_symbol* param : params) {
+      slots_[param] = formula_.slots_.size();
+      formula_.slots_.push_back(AtomIndex::kNotFound);
+    }
+  }
+
+  void Compile(const VAL::goal* goal);
+
+ private:
+
+  size_t Emit(OpCode opcode) {
+    formula_.instructions_.push_back({ opcode, 0, formula_.data_.size() });
+    return formula_.instructions_.size() - 1;
+  }
+
+  void Close(size_t idx) { formula_.instructions_[idx].idx_end = formula_.instructions_.size(); }
+
+  void CompileAtom(const VAL::proposition* prop);
+
+  void CompileQuantifier(const VAL::qfied_goal* qfied_goal);
+
+  void CompileQuantifierLoop(const VAL::qfied_goal* qfied_goal);
+
+  size_t Slot(const VAL::parameter_symbol* symbol);
+
+  size_t ConstantSlot(size_t idx_object);
+
+  bool IsConstant(size_t idx_slot) const {
+    return formula_.slots_[idx_slot] != AtomIndex::kNotFound;
+  }
+
+  Formula& formula_;
+  const AtomIndex& atoms_;
+
+  // Innermost bindings shadow outer ones
+  std::map<const VAL::parameter_symbol*, size_t> slots_;
+  std::map<size_t, size_t> constant_slots_;  // Object id to slot
+
+};
+
+size_t Formula::Compiler::Slot(const VAL::parameter_symbol* symbol) {
+  auto it = slots_.find(symbol);
+  if (it != slots_.end()) return it->second;
+
+  // Treat unbound symbols as constants
+  const size_t idx_object = atoms_.ObjectId(symbol);
+  if (idx_object == AtomIndex::kNotFound) {
+    throw std::runtime_error("Formula(): Symbol " + symbol->getName() + " is not an object.");
+  }
+  return ConstantSlot(idx_object);
+}
+
+size_t Formula::Compiler::ConstantSlot(size_t idx_object) {
+  auto it = constant_slots_.find(idx_object);
+  if (it != constant_slots_.end()) return it->second;
+
+  const size_t idx_slot = formula_.slots_.size();
+  formula_.slots_.push_back(idx_object);
+  constant_slots_[idx_object] = idx_slot;
+  return idx_slot;
+}
+
+void Formula::Compiler::CompileAtom(const VAL::proposition* prop) {
+  const std::string& name_predicate = prop->head->getName();
+  std::vector<size_t> idx_args;
+  idx_args.reserve(prop->args->size());
+  for (const VAL::parameter_symbol* arg : *prop->args) {
+    idx_args.push_back(Slot(arg));
+  }
+  const bool is_ground = std::all_of(idx_args.begin(), idx_args.end(),
+                                     [this](size_t idx_slot) { return IsConstant(idx_slot); });
+
+  // Equality is not indexed
+  if (name_predicate == "=") {
+    if (is_ground) {
+      // Empty conjunctions are true and empty disjunctions false
+      const bool is_equal = formula_.slots_[idx_args[0]] == formula_.slots_[idx_args[1]];
+      Close(Emit(is_equal ? OpCode::kAnd : OpCode::kOr));
+      return;
+    }
+    Close(Emit(OpCode::kEqual));
+    formula_.data_.insert(formula_.data_.end(), idx_args.begin(), idx_args.end());
+    return;
+  }
+
+  const size_t idx_predicate = atoms_.PredicateIndex(name_predicate);
+  if (idx_predicate == AtomIndex::kNotFound) {
+    throw std::runtime_error("Formula(): Predicate " + name_predicate + " is not declared.");
+  }
+
+  // Resolve atoms with constant arguments now
+  if (is_ground) {
+    Close(Emit(OpCode::kAtomId));
+    formula_.data_.push_back(atoms_.AtomId(idx_predicate, formula_.slots_.data(), idx_args.data()));
+    return;
+  }
+
+  Close(Emit(OpCode::kAtom));
+  formula_.data_.push_back(idx_predicate);
+  formula_.data_.insert(formula_.data_.end(), idx_args.begin(), idx_args.end());
+}
+
+void Formula::Compiler::CompileQuantifier(const VAL::qfied_goal* qfied_goal) {
+  const bool is_forall = qfied_goal->getQuantifier() == VAL::quantifier::E_FORALL;
+  const VAL::var_symbol_list* vars = qfied_goal->getVars();
+
+  std::map<const VAL::parameter_symbol*, size_t> shadowed;
+  for (const VAL::var_symbol* var : *vars) {
+    auto it = slots_.find(var);
+    if (it != slots_.end()) shadowed.insert(*it);
+  }
+
+  // Expand into one copy of the body per binding
+  const size_t num_instructions = formula_.instructions_.size();
+  const size_t num_data = formula_.data_.size();
+  const size_t num_domains = formula_.domains_.size();
+  const size_t num_slots = formula_.slots_.size();
+  const size_t idx = Emit(is_forall ? OpCode::kAnd : OpCode::kOr);
+  bool is_expanded = true;
+  ParameterGenerator gen(atoms_.objects(), vars);
+  for (const std::vector<const VAL::parameter_symbol*>& objects : gen) {
+    size_t i = 0;
+    for (const VAL::var_symbol* var : *vars) {
+      slots_[var] = ConstantSlot(atoms_.ObjectId(objects[i++]));
+    }
+    Compile(qfied_goal->getGoal());
+    if (formula_.instructions_.size() - num_instructions > kMaxExpandedInstructions) {
+      is_expanded = false;
+      break;
+    }
+  }
+
+  if (is_expanded) {
+    Close(idx);
+  } else {
+    // Fall back to looping over the objects during evaluation
+    formula_.instructions_.resize(num_instructions);
+    formula_.data_.resize(num_data);
+    formula_.domains_.resize(num_domains);
+    formula_.slots_.resize(num_slots);
+    for (auto it = constant_slots_.begin(); it != constant_slots_.end();) {
+      it = it->second >= num_slots ? constant_slots_.erase(it) : std::next(it);
+    }
+    CompileQuantifierLoop(qfied_goal);
+  }
+
+  // Restore outer bindings
+  for (const VAL::var_symbol* var : *vars) {
+    slots_.erase(var);
+  }
+  slots_.insert(shadowed.begin(), shadowed.end());
+}
+
+void Formula::Compiler::CompileQuantifierLoop(const VAL::qfied_goal* qfied_goal) {
+  const bool is_forall = qfied_goal->getQuantifier() == VAL::quantifier::E_FORALL;
+  const size_t idx = Emit(is_forall ? OpCode::kForall : OpCode::kExists);
+
+  // Bind quantified variables to new slots
+  const VAL::var_symbol_list* vars = qfied_goal->getVars();
+  formula_.data_.push_back(vars->size());
+  for (const VAL::var_symbol* var : *vars) {
+    const size_t idx_slot = formula_.slots_.size();
+    formula_.slots_.push_back(AtomIndex::kNotFound);
+    slots_[var] = idx_slot;
+
+    // Types without objects have an empty domain
+    std::vector<size_t> domain;
+    auto it = atoms_.objects()->find(var->type);
+    if (it != atoms_.objects()->end()) {
+      for (const VAL::parameter_symbol* object : it->second) {
+        domain.push_back(atoms_.ObjectId(object));
+      }
+    }
+    formula_.data_.push_back(idx_slot);
+    formula_.data_.push_back(formula_.domains_.size());
+    formula_.domains_.push_back(std::move(domain));
+  }
+
+  Compile(qfied_goal->getGoal());
+  Close(idx);
+}
+
+void Formula::Compiler::Compile(const VAL::goal* goal) {
+  // Proposition
+  const VAL::simple_goal* simple_goal = dynamic_cast<const VAL::simple_goal*>(goal);
+  if (simple_goal != nullptr) {
+    CompileAtom(simple_goal->getProp());
+    return;
+  }
+
+  // Conjunction
+  const VAL::conj_goal* conj_goal = dynamic_cast<const VAL::conj_goal*>(goal);
+  if (conj_goal != nullptr) {
+    const size_t idx = Emit(OpCode::kAnd);
+    for (const VAL::goal* g : *conj_goal->getGoals()) {
+      Compile(g);
+    }
+    Close(idx);
+    return;
+  }
+
+  // Disjunction
+  const VAL::disj_goal* disj_goal = dynamic_cast<const VAL::disj_goal*>(goal);
+  if (disj_goal != nullptr) {
+    const size_t idx = Emit(OpCode::kOr);
+    for (const VAL::goal* g : *disj_goal->getGoals()) {
+      Compile(g);
+    }
+    Close(idx);
+    return;
+  }
+
+  // Negation
+  const VAL::neg_goal* neg_goal = dynamic_cast<const VAL::neg_goal*>(goal);
+  if (neg_goal != nullptr) {
+    const size_t idx = Emit(OpCode::kNot);
+    Compile(neg_goal->getGoal());
+    Close(idx);
+    return;
+  }
+
+  // Forall/exists
+  const VAL::qfied_goal* qfied_goal = dynamic_cast<const VAL::qfied_goal*>(goal);
+  if (qfied_goal != nullptr) {
+    CompileQuantifier(qfied_goal);
+    return;
+  }
+
+  throw std::runtime_error("Formula(): Goal type not implemented.");
+}
+
+Formula::Formula(const std::shared_ptr<const AtomIndex>& atoms, const VAL::goal* goal,
+                 const std::vector<const VAL::parameter_symbol*>& params)
+    : atoms_(atoms), num_params_(params.size()) {
+  Compiler compiler(this, params);
+  compiler.Compile(goal);
+}
+
+bool Formula::operator()(const State& state,
+                         const std::vector<const VAL::parameter_symbol*>& args) const {
+  if (args.size() != num_params_) {
+    throw std::runtime_error("Formula(): Expected " + std::to_string(num_params_) +
+                             " arguments but received " + std::to_string(args.size()) + ".");
+  }
+
+  // Initialize slots on the stack if possible
+  std::array<size_t, kNumStackSlots> stack_slots;
+  std::vector<size_t> heap_slots;
+  size_t* slots = stack_slots.data();
+  if (slots_.size() > kNumStackSlots) {
+    heap_slots.resize(slots_.size());
+    slots = heap_slots.data();
+  }
+  std::copy(slots_.begin(), slots_.end(), slots);
+
+  for (size_t i = 0; i < num_params_; i++) {
+    slots[i] = atoms_->ObjectId(args[i]);
+    if (slots[i] == AtomIndex::kNotFound) {
+      throw std::runtime_error("Formula(): Argument " + args[i]->getName() + " is not an object.");
+    }
+  }
+
+  return Evaluate(0, state, slots);
+}
+
+bool Formula::Evaluate(size_t idx, const State& state, size_t* slots) const {
+  const Instruction& instruction = instructions_[idx];
+  const size_t* data = data_.data() + instruction.idx_data;
+  switch (instruction.opcode) {
+    case OpCode::kAtom: {
+      const size_t idx_atom = atoms_->AtomId(data[0], slots, data + 1);
+      return idx_atom != AtomIndex::kNotFound && state.Contains(idx_atom);
+    }
+    case OpCode::kAtomId:
+      return data[0] != AtomIndex::kNotFound && state.Contains(data[0]);
+    case OpCode::kEqual:
+      return slots[data[0]] == slots[data[1]];
+    case OpCode::kAnd:
+      for (size_t i = idx + 1; i < instruction.idx_end; i = instructions_[i].idx_end) {
+        if (!Evaluate(i, state, slots)) return false;
+      }
+      return true;
+    case OpCode::kOr:
+      for (size_t i = idx + 1; i < instruction.idx_end; i = instructions_[i].idx_end) {
+        if (Evaluate(i, state, slots)) return true;
+      }
+      return false;
+    case OpCode::kNot:
+      return !Evaluate(idx + 1, state, slots);
+    case OpCode::kForall:
+      return Quantify(idx, 0, data[0], true, state, slots);
+    case OpCode::kExists:
+      return Quantify(idx, 0, data[0], false, state, slots);
+  }
+  return false;
+}
+
+bool Formula::Quantify(size_t idx, size_t idx_var, size_t num_vars, bool is_forall,
+                       const State& state, size_t* slots) const {
+  if (idx_var == num_vars) return Evaluate(idx + 1, state, slots);
+
+  // Bind the next variable to each object of its type
+  const size_t* data = data_.data() + instructions_[idx].idx_data + 1 + 2 * idx_var;
+  size_t& slot = slots[data[0]];
+  for (size_t idx_object : domains_[data[1]]) {
+    slot = idx_object;
+    if (Quantify(idx, idx_var + 1, num_vars, is_forall, state, slots) != is_forall) {
+      return !is_forall;
+    }
+  }
+  return is_forall;
+}
+
+}  // namespace logic_opt
@@ -0,0 +1,486 @@
+/**
+ * grounding.cc
+ *
+ * Copyright 2026. All Rights Reserved.
+ *
+ * Created: October 17, 2026
+ * Authors: Toki Migimatsu
+ */
+
+#include "logic_opt/planning/grounding.h"
+
+#include <algorithm>  // std::any_of, std::remove_if, std::set_intersection, std::sort, std::unique
+#include <iterator>   // std::back_inserter, std::make_move_iterator
+#include <map>        // std::map
+#include <set>        // std::set
+#include <stdexcept>  // std::invalid_argument, std::runtime_error
+#include <string>     // std::to_string
+
+#include "logic_opt/planning/parameter_generator.h"
+
+namespace logic_opt {
+
+namespace {
+
+// Limit on the number of DNF terms before conjunctions are kept nested
+constexpr size_t kMaxTerms = 4096;
+
+using Bindings = std::map<const VAL::parameter_symbol*, const VAL::parameter_symbol*>;
+
+GroundCondition True() {
+  GroundCondition condition;
+  condition.terms.emplace_back();
+  return condition;
+}
+
+GroundCondition False() {
+  return GroundCondition();
+}
+
+void Normalize(std::vector<size_t>* atoms) {
+  std::sort(atoms->begin(), atoms->end());
+  atoms->erase(std::unique(atoms->begin(), atoms->end()), atoms->end());
+}
+
+/**
+ * Merge two conjunctions. Returns false if the result is contradictory.
+ */
+bool Merge(const GroundConjunction& a, const GroundConjunction& b, GroundConjunction* ab) {
+  ab->pos = a.pos;
+  ab->pos.insert(ab->pos.end(), b.pos.begin(), b.pos.end());
+  ab->neg = a.neg;
+  ab->neg.insert(ab->neg.end(), b.neg.begin(), b.neg.end());
+  Normalize(&ab->pos);
+  Normalize(&ab->neg);
+
+  std::vector<size_t> conflicts;
+  std::set_intersection(ab->pos.begin(), ab->pos.end(), ab->neg.begin(), ab->neg.end(),
+                        std::back_inserter(conflicts));
+  return conflicts.empty();
+}
+
+GroundCondition Conjoin(const GroundCondition& a, const GroundCondition& b) {
+  if (a.IsFalse() || b.IsFalse()) return False();
+  if (a.IsTrue()) return b;
+  if (b.IsTrue()) return a;
+
+  // Keep the operands nested if distributing them would blow up the DNF
+  if (!a.disjuncts.empty() || !b.disjuncts.empty() ||
+      a.terms.size() * b.terms.size() > kMaxTerms) {
+    GroundCondition ab = a;
+    ab.conjuncts.push_back(b);
+    return ab;
+  }
+
+  GroundCondition ab;
+  for (const GroundConjunction& term_a : a.terms) {
+    for (const GroundConjunction& term_b : b.terms) {
+      GroundConjunction term;
+      if (!Merge(term_a, term_b, &term)) continue;
+      ab.terms.push_back(std::move(term));
+    }
+  }
+  if (ab.IsFalse()) return ab;
+  ab.conjuncts = a.conjuncts;
+  ab.conjuncts.insert(ab.conjuncts.end(), b.conjuncts.begin(), b.conjuncts.end());
+  return ab;
+}
+
+GroundCondition Disjoin(GroundCondition&& a, GroundCondition&& b) {
+  if (a.IsTrue() || b.IsFalse()) return std::move(a);
+  if (b.IsTrue() || a.IsFalse()) return std::move(b);
+
+  // Operands with conjuncts can only be disjoined as nested conditions
+  GroundCondition ab;
+  for (GroundCondition* x : { &a, &b }) {
+    if (!x->conjuncts.empty()) {
+      ab.disjuncts.push_back(std::move(*x));
+      continue;
+    }
+    ab.terms.insert(ab.terms.end(), std::make_move_iterator(x->terms.begin()),
+                    std::make_move_iterator(x->terms.end()));
+    ab.disjuncts.insert(ab.disjuncts.end(), std::make_move_iterator(x->disjuncts.begin()),
+                        std::make_move_iterator(x->disjuncts.end()));
+  }
+  return ab;
+}
+
+/**
+ * Predicates that appear in some action effect.
+ */
+void FindFluentPredicates(const VAL::effect_lists* effects, std::set<std::string>* fluents) {
+  for (const VAL::simple_effect* effect : effects->add_effects) {
+    fluents->insert(effect->prop->head->getName());
+  }
+  for (const VAL::simple_effect* effect : effects->del_effects) {
+    fluents->insert(effect->prop->head->getName());
+  }
+  for (const VAL::forall_effect* effect : effects->forall_effects) {
+    FindFluentPredicates(effect->getEffects(), fluents);
+  }
+  for (const VAL::cond_effect* effect : effects->cond_effects) {
+    FindFluentPredicates(effect->getEffects(), fluents);
+  }
+}
+
+class Grounder {
+
+ public:
+
+  /**
+   * Static atoms are evaluated on the initial state, unless it is null.
+   */
+  Grounder(const VAL::domain* domain, const AtomIndex& atoms, const State* initial_state)
+      : atoms_(atoms), initial_state_(initial_state) {
+    for (const VAL::operator_* op : *domain->ops) {
+      FindFluentPredicates(op->effects, &fluents_);
+    }
+  }
+
+  GroundCondition Condition(const VAL::goal* goal, Bindings* bindings, bool negated = false) const;
+
+  void Effects(const VAL::effect_lists* effects, const GroundCondition& condition,
+               Bindings* bindings, std::vector<size_t>* add, std::vector<size_t>* del,
+               std::vector<GroundEffect>* cond_effects) const;
+
+ private:
+
+  std::vector<const VAL::parameter_symbol*> Arguments(const VAL::proposition* prop,
+                                                      const Bindings& bindings) const;
+
+  size_t EffectAtomId(const VAL::proposition* prop, const Bindings& bindings) const;
+
+  GroundCondition Literal(const VAL::proposition* prop, const Bindings& bindings,
+                          bool negated) const;
+
+  GroundCondition Quantifier(const VAL::qfied_goal* qfied_goal, Bindings* bindings,
+                             bool negated) const;
+
+  const AtomIndex& atoms_;
+  const State* initial_state_;
+  std::set<std::string> fluents_;
+
+};
+
+std::vector<const VAL::parameter_symbol*> Grounder::Arguments(const VAL::proposition* prop,
+                                                              const Bindings& bindings) const {
+  // Unbound symbols are constants
+  std::vector<const VAL::parameter_symbol*> args;
+  args.reserve(prop->args->size());
+  for (const VAL::parameter_symbol* param : *prop->args) {
+    auto it = bindings.find(param);
+    args.push_back(it == bindings.end() ? param : it->second);
+  }
+  return args;
+}
+
+size_t Grounder::EffectAtomId(const VAL::proposition* prop, const Bindings& bindings) const {
+  const size_t idx_predicate = atoms_.PredicateIndex(prop->head->getName());
+  if (idx_predicate == AtomIndex::kNotFound) {
+    throw std::runtime_error("GroundActions(): Predicate " + prop->head->getName() + " is not declared.");
+  }
+  const size_t idx_atom = atoms_.AtomId(idx_predicate, Arguments(prop, bindings));
+  if (idx_atom == AtomIndex::kNotFound) {
+    throw std::runtime_error("GroundActions(): Effect " + prop->head->getName() + " has invalid arguments.");
+  }
+  return idx_atom;
+}
+
+GroundCondition Grounder::Literal(const VAL::proposition* prop, const Bindings& bindings,
+                                  bool negated) const {
+  const std::vector<const VAL::parameter_symbol*> args = Arguments(prop, bindings);
+  const std::string& name_predicate = prop->head->getName();
+
+  // Equality
+  if (name_predicate == "=") {
+    return (args[0] == args[1]) != negated ? True() : False();
+  }
+
+  const size_t idx_predicate = atoms_.PredicateIndex(name_predicate);
+  if (idx_predicate == AtomIndex::kNotFound) {
+    throw std::runtime_error("GroundCondition(): Predicate " + name_predicate + " is not declared.");
+  }
+
+  // Type-incorrect atoms are never true
+  const size_t idx_atom = atoms_.AtomId(idx_predicate, args);
+  if (idx_atom == AtomIndex::kNotFound) return negated ? True() : False();
+
+  // Static atoms
+  if (initial_state_ != nullptr && fluents_.find(name_predicate) == fluents_.end()) {
+    return initial_state_->Contains(idx_atom) != negated ? True() : False();
+  }
+
+  GroundCondition condition = True();
+  if (negated) {
+    condition.terms.front().neg.push_back(idx_atom);
+  } else {
+    condition.terms.front().pos.push_back(idx_atom);
+  }
+  return condition;
+}
+
+GroundCondition Grounder::Quantifier(const VAL::qfied_goal* qfied_goal, Bindings* bindings,
+                                     bool negated) const {
+  // Negation swaps forall and exists
+  const bool is_conjunction = (qfied_goal->getQuantifier() == VAL::quantifier::E_FORALL) != negated;
+  const VAL::var_symbol_list* qfied_vars = qfied_goal->getVars();
+
+  GroundCondition condition = is_conjunction ? True() : False();
+  ParameterGenerator gen(atoms_.objects(), qfied_vars);
+  for (const std::vector<const VAL::parameter_symbol*>& variables : gen) {
+    size_t i = 0;
+    for (const VAL::var_symbol* var : *qfied_vars) {
+      (*bindings)[var] = variables[i++];
+    }
+    GroundCondition sub = Condition(qfied_goal->getGoal(), bindings, negated);
+    condition = is_conjunction ? Conjoin(condition, sub) : Disjoin(std::move(condition), std::move(sub));
+    if (is_conjunction ? condition.IsFalse() : condition.IsTrue()) break;
+  }
+  for (const VAL::var_symbol* var : *qfied_vars) {
+    bindings->erase(var);
+  }
+  return condition;
+}
+
+GroundCondition Grounder::Condition(const VAL::goal* goal, Bindings* bindings, bool negated) const {
+  // Proposition
+  const VAL::simple_goal* simple_goal = dynamic_cast<const VAL::simple_goal*>(goal);
+  if (simple_goal != nullptr) {
+    return Literal(simple_goal->getProp(), *bindings, negated);
+  }
+
+  // Conjunction and disjunction (swapped under negation)
+  const VAL::conj_goal* conj_goal = dynamic_cast<const VAL::conj_goal*>(goal);
+  const VAL::disj_goal* disj_goal = dynamic_cast<const VAL::disj_goal*>(goal);
+  if (conj_goal != nullptr || disj_goal != nullptr) {
+    const bool is_conjunction = (conj_goal != nullptr) != negated;
+    const VAL::goal_list* goals = conj_goal != nullptr ? conj_goal->getGoals() : disj_goal->getGoals();
+    GroundCondition condition = is_conjunction ? True() : False();
+    for (const VAL::goal* g : *goals) {
+      GroundCondition sub = Condition(g, bindings, negated);
+      condition = is_conjunction ? Conjoin(condition, sub) : Disjoin(std::move(condition), std::move(sub));
+      if (is_conjunction ? condition.IsFalse() : condition.IsTrue()) break;
+    }
+    return condition;
+  }
+
+  // Negation
+  const VAL::neg_goal* neg_goal = dynamic_cast<const VAL::neg_goal*>(goal);
+  if (neg_goal != nullptr) {
+    return Condition(neg_goal->getGoal(), bindings, !negated);
+  }
+
+  // Forall and exists
+  const VAL::qfied_goal* qfied_goal = dynamic_cast<const VAL::qfied_goal*>(goal);
+  if (qfied_goal != nullptr) {
+    return Quantifier(qfied_goal, bindings, negated);
+  }
+
+  throw std::runtime_error("GroundCondition(): Goal type not implemented.");
+}
+
+void Grounder::Effects(const VAL::effect_lists* effects, const GroundCondition& condition,
+                       Bindings* bindings, std::vector<size_t>* add, std::vector<size_t>* del,
+                       std::vector<GroundEffect>* cond_effects) const {
+  // Collect unconditional effects in the given lists, and conditional ones in a new entry
+  GroundEffect cond_effect;
+  const bool is_conditional = !condition.IsTrue();
+  std::vector<size_t>* effect_add = add;
+  std::vector<size_t>* effect_del = del;
+  if (is_conditional) {
+    cond_effect.condition = condition;
+    effect_add = &cond_effect.add;
+    effect_del = &cond_effect.del;
+  }
+
+  for (const VAL::forall_effect* forall_effect : effects->forall_effects) {
+    const VAL::var_symbol_list* forall_params = forall_effect->getVarsList();
+    ParameterGenerator gen(atoms_.objects(), forall_params);
+    for (const std::vector<const VAL::parameter_symbol*>& variables : gen) {
+      size_t i = 0;
+      for (const VAL::var_symbol* var : *forall_params) {
+        (*bindings)[var] = variables[i++];
+      }
+      Effects(forall_effect->getEffects(), condition, bindings, add, del, cond_effects);
+    }
+    for (const VAL::var_symbol* var : *forall_params) {
+      bindings->erase(var);
+    }
+  }
+  for (const VAL::simple_effect* effect : effects->add_effects) {
+    effect_add->push_back(EffectAtomId(effect->prop, *bindings));
+  }
+  for (const VAL::simple_effect* effect : effects->del_effects) {
+    effect_del->push_back(EffectAtomId(effect->prop, *bindings));
+  }
+
+  if (is_conditional && !(cond_effect.add.empty() && cond_effect.del.empty())) {
+    Normalize(&cond_effect.add);
+    Normalize(&cond_effect.del);
+    cond_effects->push_back(std::move(cond_effect));
+  }
+
+  for (const VAL::cond_effect* effect : effects->cond_effects) {
+    GroundCondition sub = Conjoin(condition, Condition(effect->getCondition(), bindings));
+    if (sub.IsFalse()) continue;
+    Effects(effect->getEffects(), sub, bindings, add, del, cond_effects);
+  }
+}
+
+/**
+ * Test whether the condition holds when only its positive literals are
+ * checked against the reachable atoms.
+ */
+bool IsReachable(const GroundCondition& condition, const State& reachable) {
+  for (const GroundCondition& conjunct : condition.conjuncts) {
+    if (!IsReachable(conjunct, reachable)) return false;
+  }
+  const bool is_term_reachable = std::any_of(condition.terms.begin(), condition.terms.end(),
+                                             [&reachable](const GroundConjunction& term) {
+    for (size_t idx_atom : term.pos) {
+      if (!reachable.Contains(idx_atom)) return false;
+    }
+    return true;
+  });
+  if (is_term_reachable) return true;
+  return std::any_of(condition.disjuncts.begin(), condition.disjuncts.end(),
+                     [&reachable](const GroundCondition& disjunct) {
+    return IsReachable(disjunct, reachable);
+  });
+}
+
+/**
+ * Atoms reachable under the delete relaxation (negative literals are ignored).
+ */
+State ReachableAtoms(const std::vector<GroundAction>& actions, const State& initial_state) {
+  State reachable(initial_state);
+  bool is_updated = true;
+  while (is_updated) {
+    is_updated = false;
+    for (const GroundAction& action : actions) {
+      if (!IsReachable(action.precondition(), reachable)) continue;
+
+      std::vector<const std::vector<size_t>*> adds = { &action.add() };
+      for (const GroundEffect& effect : action.cond_effects()) {
+        if (IsReachable(effect.condition, reachable)) adds.push_back(&effect.add);
+      }
+      for (const std::vector<size_t>* add : adds) {
+        for (size_t idx_atom : *add) {
+          if (reachable.Contains(idx_atom)) continue;
+          reachable.Add(idx_atom);
+          is_updated = true;
+        }
+      }
+    }
+  }
+  return reachable;
+}
+
+}  // namespace
+
+bool GroundCondition::IsTrue() const {
+  if (!conjuncts.empty()) return false;
+  const bool is_term_true = std::any_of(terms.begin(), terms.end(), [](const GroundConjunction& term) {
+    return term.pos.empty() && term.neg.empty();
+  });
+  return is_term_true || std::any_of(disjuncts.begin(), disjuncts.end(),
+                                     [](const GroundCondition& disjunct) { return disjunct.IsTrue(); });
+}
+
+State GroundAction::Apply(const State& state) const {
+  // Conditions are evaluated on the pre-state, and adds win over deletes
+  std::vector<const GroundEffect*> effects;
+  effects.reserve(cond_effects_.size());
+  for (const GroundEffect& effect : cond_effects_) {
+    if (effect.condition.IsSatisfied(state)) effects.push_back(&effect);
+  }
+
+  State next_state(state);
+  for (size_t idx_atom : del_) {
+    next_state.Remove(idx_atom);
+  }
+  for (const GroundEffect* effect : effects) {
+    for (size_t idx_atom : effect->del) {
+      next_state.Remove(idx_atom);
+    }
+  }
+  for (size_t idx_atom : add_) {
+    next_state.Add(idx_atom);
+  }
+  for (const GroundEffect* effect : effects) {
+    for (size_t idx_atom : effect->add) {
+      next_state.Add(idx_atom);
+    }
+  }
+  return next_state;
+}
+
+std::vector<GroundAction> GroundActions(const VAL::domain* domain, const AtomIndex& atoms,
+                                        const State& initial_state) {
+  const Grounder grounder(domain, atoms, &initial_state);
+
+  std::vector<GroundAction> actions;
+  for (const VAL::operator_* op : *domain->ops) {
+    ParameterGenerator gen(atoms.objects(), op->parameters);
+    for (const std::vector<const VAL::parameter_symbol*>& args : gen) {
+      Bindings bindings;
+      size_t i = 0;
+      for (const VAL::var_symbol* param : *op->parameters) {
+        bindings[param] = args[i++];
+      }
+
+      // Skip actions with unsatisfiable static preconditions
+      GroundCondition precondition = grounder.Condition(op->precondition, &bindings);
+      if (precondition.IsFalse()) continue;
+
+      GroundAction action(op, std::vector<const VAL::parameter_symbol*>(args));
+      action.precondition_ = std::move(precondition);
+      grounder.Effects(op->effects, True(), &bindings, &action.add_, &action.del_,
+                       &action.cond_effects_);
+      Normalize(&action.add_);
+      Normalize(&action.del_);
+      actions.push_back(std::move(action));
+    }
+  }
+
+  // Prune actions that are unreachable even under the delete relaxation
+  const State reachable = ReachableAtoms(actions, initial_state);
+  actions.erase(std::remove_if(actions.begin(), actions.end(), [&reachable](const GroundAction& action) {
+    return !IsReachable(action.precondition(), reachable);
+  }), actions.end());
+
+  return actions;
+}
+
+GroundAction GroundOperator(const VAL::domain* domain, const AtomIndex& atoms,
+                            const VAL::operator_* op,
+                            const std::vector<const VAL::parameter_symbol*>& args) {
+  if (args.size() != op->parameters->size()) {
+    throw std::invalid_argument("GroundOperator(): Expected " + std::to_string(op->parameters->size()) +
+                                " arguments but received " + std::to_string(args.size()) + ".");
+  }
+  const Grounder grounder(domain, atoms, nullptr);
+
+  Bindings bindings;
+  size_t i = 0;
+  for (const VAL::var_symbol* param : *op->parameters) {
+    bindings[param] = args[i++];
+  }
+
+  GroundAction action(op, std::vector<const VAL::parameter_symbol*>(args));
+  action.precondition_ = grounder.Condition(op->precondition, &bindings);
+  grounder.Effects(op->effects, True(), &bindings, &action.add_, &action.del_,
+                   &action.cond_effects_);
+  Normalize(&action.add_);
+  Normalize(&action.del_);
+  return action;
+}
+
+GroundCondition GroundGoal(const VAL::domain* domain, const VAL::problem* problem,
+                           const AtomIndex& atoms, const State& initial_state) {
+  const Grounder grounder(domain, atoms, &initial_state);
+  Bindings bindings;
+  return grounder.Condition(problem->the_goal, &bindings);
+}
+
+}  // namespace logic_opt
@@ -0,0 +1,193 @@
+/**
+ * heuristics.cc
+ *
+ * Copyright 2026. All Rights Reserved.
+ *
+ * Created: October 17, 2026
+ * Authors: Toki Migimatsu
+ */
+
+#include "logic_opt/planning/heuristics.h"
+
+#include <algorithm>   // std::max, std::set_union
+#include <functional>  // std::greater
+#include <iterator>    // std::back_inserter
+#include <queue>       // std::priority_queue
+#include <stdexcept>   // std::invalid_argument
+#include <utility>     // std::pair
+
+namespace logic_opt {
+
+constexpr size_t RelaxedPlanningGraph::kInfinity;
+
+namespace {
+
+/**
+ * Terms of the condition and its nested disjuncts. Nested conjuncts are
+ * dropped, which only weakens the relaxed precondition.
+ */
+void RelaxedTerms(const GroundCondition& condition, std::vector<const GroundConjunction*>* terms) {
+  for (const GroundConjunction& term : condition.terms) {
+    terms->push_back(&term);
+  }
+  for (const GroundCondition& disjunct : condition.disjuncts) {
+    RelaxedTerms(disjunct, terms);
+  }
+}
+
+std::vector<const GroundConjunction*> RelaxedTerms(const GroundCondition& condition) {
+  std::vector<const GroundConjunction*> terms;
+  RelaxedTerms(condition, &terms);
+  return terms;
+}
+
+}  // namespace
+
+HeuristicType ParseHeuristicType(const std::string& name) {
+  if (name == "max") return HeuristicType::kMax;
+  if (name == "add") return HeuristicType::kAdd;
+  if (name == "ff") return HeuristicType::kFF;
+  throw std::invalid_argument("ParseHeuristicType(): Invalid heuristic '" + name + "'.");
+}
+
+RelaxedPlanningGraph::RelaxedPlanningGraph(const std::vector<GroundAction>& actions,
+                                           const GroundCondition& goal, size_t num_atoms,
+                                           HeuristicType type)
+    : type_(type), num_actions_(actions.size()), atom_operators_(num_atoms) {
+
+  // Create one operator per precondition term and conditional effect term
+  for (size_t idx_action = 0; idx_action < actions.size(); idx_action++) {
+    const GroundAction& action = actions[idx_action];
+    for (const GroundConjunction* term : RelaxedTerms(action.precondition())) {
+      if (!action.add().empty()) {
+        operators_.push_back({ term->pos, action.add(), idx_action });
+      }
+      for (const GroundEffect& effect : action.cond_effects()) {
+        if (effect.add.empty()) continue;
+        for (const GroundConjunction* effect_term : RelaxedTerms(effect.condition)) {
+          Operator op;
+          std::set_union(term->pos.begin(), term->pos.end(),
+                         effect_term->pos.begin(), effect_term->pos.end(),
+                         std::back_inserter(op.pre));
+          op.add = effect.add;
+          op.idx_action = idx_action;
+          operators_.push_back(std::move(op));
+        }
+      }
+    }
+  }
+
+  // Goal terms are operators without effects
+  idx_goals_ = operators_.size();
+  for (const GroundConjunction* term : RelaxedTerms(goal)) {
+    operators_.push_back({ term->pos, {}, kInfinity });
+  }
+
+  for (size_t idx_op = 0; idx_op < operators_.size(); idx_op++) {
+    for (size_t idx_atom : operators_[idx_op].pre) {
+      atom_operators_[idx_atom].push_back(idx_op);
+    }
+  }
+}
+
+size_t RelaxedPlanningGraph::Evaluate(const State& state, HeuristicType type) const {
+  std::vector<size_t> costs;
+  std::vector<size_t> supporters;
+  size_t goal_cost;
+  const size_t idx_goal = ComputeCosts(state, type != HeuristicType::kMax, costs, supporters,
+                                       goal_cost);
+  if (idx_goal == kInfinity) return kInfinity;
+  if (type != HeuristicType::kFF) return goal_cost;
+  return ExtractRelaxedPlan(idx_goal, costs, supporters);
+}
+
+size_t RelaxedPlanningGraph::ComputeCosts(const State& state, bool is_additive,
+                                          std::vector<size_t>& costs,
+                                          std::vector<size_t>& supporters,
+                                          size_t& goal_cost) const {
+  using CostAtom = std::pair<size_t, size_t>;
+  std::priority_queue<CostAtom, std::vector<CostAtom>, std::greater<CostAtom>> queue;
+
+  costs.assign(atom_operators_.size(), kInfinity);
+  supporters.assign(atom_operators_.size(), kInfinity);
+  std::vector<bool> is_closed(atom_operators_.size(), false);
+  std::vector<size_t> num_unsatisfied(operators_.size());
+  std::vector<size_t> pre_costs(operators_.size(), 0);
+
+  size_t idx_goal = kInfinity;
+  goal_cost = kInfinity;
+
+  // Propagate the cost of an operator whose preconditions are all reached
+  auto Trigger = [&](size_t idx_op) {
+    if (idx_op >= idx_goals_) {
+      if (pre_costs[idx_op] < goal_cost) {
+        goal_cost = pre_costs[idx_op];
+        idx_goal = idx_op;
+      }
+      return;
+    }
+    const size_t cost = pre_costs[idx_op] + 1;
+    for (size_t idx_atom : operators_[idx_op].add) {
+      if (cost >= costs[idx_atom]) continue;
+      costs[idx_atom] = cost;
+      supporters[idx_atom] = idx_op;
+      queue.emplace(cost, idx_atom);
+    }
+  };
+
+  for (size_t i = 0; i < atom_operators_.size(); i++) {
+    if (!state.Contains(i)) continue;
+    costs[i] = 0;
+    queue.emplace(0, i);
+  }
+  for (size_t idx_op = 0; idx_op < operators_.size(); idx_op++) {
+    num_unsatisfied[idx_op] = operators_[idx_op].pre.size();
+    if (num_unsatisfied[idx_op] == 0) Trigger(idx_op);
+  }
+
+  // Generalized Dijkstra: atoms are closed in order of cost
+  while (!queue.empty()) {
+    const size_t cost = queue.top().first;
+    const size_t idx_atom = queue.top().second;
+    queue.pop();
+
+    // Remaining operators cost at least as much as the best goal term
+    if (cost >= goal_cost) break;
+    if (is_closed[idx_atom]) continue;
+    is_closed[idx_atom] = true;
+
+    for (size_t idx_op : atom_operators_[idx_atom]) {
+      pre_costs[idx_op] = is_additive ? pre_costs[idx_op] + cost : std::max(pre_costs[idx_op], cost);
+      if (--num_unsatisfied[idx_op] == 0) Trigger(idx_op);
+    }
+  }
+
+  if (idx_goal != kInfinity) idx_goal -= idx_goals_;
+  return idx_goal;
+}
+
+size_t RelaxedPlanningGraph::ExtractRelaxedPlan(size_t idx_goal, const std::vector<size_t>& costs,
+                                                const std::vector<size_t>& supporters) const {
+  std::vector<bool> is_marked(atom_operators_.size(), false);
+  std::vector<bool> is_action_used(num_actions_, false);
+  std::vector<size_t> open = operators_[idx_goals_ + idx_goal].pre;
+
+  // Walk the best supporters back from the goal, counting each action once
+  size_t num_actions = 0;
+  while (!open.empty()) {
+    const size_t idx_atom = open.back();
+    open.pop_back();
+    if (is_marked[idx_atom] || costs[idx_atom] == 0) continue;
+    is_marked[idx_atom] = true;
+
+    const Operator& op = operators_[supporters[idx_atom]];
+    if (!is_action_used[op.idx_action]) {
+      is_action_used[op.idx_action] = true;
+      num_actions++;
+    }
+    open.insert(open.end(), op.pre.begin(), op.pre.end());
+  }
+  return num_actions;
+}
+
+}  // namespace logic_opt
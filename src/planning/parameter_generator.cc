@@ -15,10 +15,13 @@ template<typename T>
 std::vector<const std::vector<const VAL::parameter_symbol*>*>
 ParamTypes(const std::shared_ptr<const ObjectTypeMap> objects,
            const VAL::typed_symbol_list<T>* params) {
+  static const std::vector<const VAL::parameter_symbol*> kNoObjects;
   std::vector<const std::vector<const VAL::parameter_symbol*>*> types;
   types.reserve(params->size());
   for (const VAL::parameter_symbol* param : *params) {
-    types.push_back(&objects->at(param->type));
+    // Types without objects produce no combinations
+    auto it = objects->find(param->type);
+    types.push_back(it != objects->end() ? &it->second : &kNoObjects);
   }
   return types;
 }
@@ -9,22 +9,11 @@
 
 #include "logic_opt/planning/planner.h"
 
-#include "logic_opt/planning/actions.h"
 
 namespace logic_opt {
 
 namespace {
 
-VAL::parameter_symbol_list CreateGoalParams(const std::shared_ptr<const ObjectTypeMap>& objects) {
-  VAL::parameter_symbol_list goal_params;
-  for (const auto& key_val : *objects) {
-    for (const VAL::parameter_symbol* object : key_val.second) {
-      goal_params.push_back(const_cast<VAL::parameter_symbol*>(object));
-    }
-  }
-  return goal_params;
-}
-
 std::set<Proposition> CreateInitialPropositions(const VAL::effect_lists* initial_state,
                                                 const VAL::const_symbol_list* constants,
                                                 const VAL::const_symbol_list* objects) {
@@ -48,25 +37,34 @@ std::set<Proposition> CreateInitialPropositions(const VAL::effect_lists* initial
 
 Planner::Planner(const VAL::domain* domain, const VAL::problem* problem)
     : objects_(CreateObjectsMap(domain->constants, problem->objects)),
-      operators_(*domain->ops),
-      goal_(problem->the_goal),
-      goal_params_(CreateGoalParams(objects_)),
-      goal_args_(goal_params_.begin(), goal_params_.end()),
-      root_(this, CreateInitialPropositions(problem->initial_state, domain->constants, problem->objects)) {}
+      atoms_(std::make_shared<const AtomIndex>(domain, objects_)),
+      root_(this, atoms_->CreateState(CreateInitialPropositions(problem->initial_state,
+                                                                domain->constants, problem->objects))),
+      actions_(GroundActions(domain, *atoms_, root_.state())),
+      goal_(GroundGoal(domain, problem, *atoms_, root_.state())) {}
+
+Planner::Node::Node(const Planner* planner, State&& state, size_t depth)
+    : planner_(planner), state_(std::move(state)), depth_(depth) {}
+
+const Proposition& Planner::Node::action() const {
+  static const Proposition kNoAction;
+  return action_ != nullptr ? action_->proposition() : kNoAction;
+}
 
-Planner::Node::Node(const Planner* planner, std::set<Proposition>&& propositions, size_t depth)
-    : planner_(planner), propositions_(std::move(propositions)), depth_(depth) {}
+std::set<Proposition> Planner::Node::propositions() const {
+  return planner_->atoms_->CreatePropositions(state_);
+}
 
 std::ostream& operator<<(std::ostream& os, const logic_opt::Planner::Node& node) {
 
   for (size_t i = 0; i < node.depth_; i++) {
     os << "-";
   }
-  os << (node.depth_ > 0 ? " " : "") << node.action_ << " -> ";
+  os << (node.depth_ > 0 ? " " : "") << node.action() << " -> ";
   std::string separator;
-  for (const auto& P : node.propositions_) {
-    if (P.predicate() == "=") continue;
-    os << separator << P;
+  for (size_t i = 0; i < node.state_.size(); i++) {
+    if (!node.state_.Contains(i)) continue;
+    os << separator << node.planner_->atoms().atom(i);
     if (separator.empty()) separator = ", ";
   }
 
@@ -75,109 +73,51 @@ std::ostream& operator<<(std::ostream& os, const logic_opt::Planner::Node& node)
 
 Planner::Node::iterator::iterator(const Node* parent)
     : planner_(parent->planner_), parent_(parent), child_(planner_, parent->depth_ + 1),
-      it_op_(planner_->operators_.begin()),
-      param_gen_(ParameterGenerator(planner_->objects_, (*it_op_)->parameters)),
-      it_param_(param_gen_.begin()) {}
+      it_action_(planner_->actions_.begin()) {}
 
 Planner::Node::iterator& Planner::Node::iterator::operator++() {
+  const std::vector<GroundAction>& actions = planner_->actions_;
+  if (it_action_ == actions.end()) return *this;
 
-  while (it_op_ != planner_->operators_.end()) {
-    const VAL::operator_* op = *it_op_;
-    if (it_param_ == param_gen_.end()) {
-      // Move onto next action
-      ++it_op_;
-      if (it_op_ == planner_->operators_.end()) break;
-      op = *it_op_;
-
-      // Generate new parameters
-      param_gen_ = ParameterGenerator(planner_->objects_, op->parameters);
-      it_param_ = param_gen_.begin();
-    } else {
-      // Move onto next parameters
-      ++it_param_;
-      if (it_param_ == param_gen_.end()) continue;
-    }
-
-    // Check action preconditions
-    const Formula& P = GetFormula(planner_->formulas_, planner_->objects_, op->precondition, op->parameters);
-    const std::vector<const VAL::parameter_symbol*>& action_args = *it_param_;
-    if (P(parent_->propositions_, action_args)) {
-      // Set action and apply postconditions to child
-      child_.action_ = Proposition(op->name->getName(), action_args);
-      child_.propositions_ = ApplyEffects(planner_->formulas_, planner_->objects_,
-                                          action_args, op->parameters,
-                                          op->effects, parent_->propositions_);
-      break;
-    }
-  }
+  for (++it_action_; it_action_ != actions.end(); ++it_action_) {
+    if (!it_action_->IsApplicable(parent_->state_)) continue;
 
+    // Set action and apply postconditions to child
+    child_.action_ = &*it_action_;
+    child_.state_ = it_action_->Apply(parent_->state_);
+    break;
+  }
   return *this;
 }
 
 Planner::Node::iterator& Planner::Node::iterator::operator--() {
+  const std::vector<GroundAction>& actions = planner_->actions_;
 
-  if (it_op_ == planner_->operators_.end()) {
-    --it_op_;
-    const VAL::operator_* op = *it_op_;
-    param_gen_ = ParameterGenerator(planner_->objects_, op->parameters);
-    it_param_ = --param_gen_.end();
-
-    const Formula& P = GetFormula(planner_->formulas_, planner_->objects_, op->precondition, op->parameters);
-    const std::vector<const VAL::parameter_symbol*>& action_args = *it_param_;
-    if (P(parent_->propositions_, action_args)) {
-      child_.action_ = Proposition(op->name->getName(), action_args);
-      child_.propositions_ = ApplyEffects(planner_->formulas_, planner_->objects_,
-                                          action_args, op->parameters,
-                                          op->effects, parent_->propositions_);
-      return *this;
-    }
-  }
+  // Don't decrement past the first applicable action
+  for (auto it = it_action_; it != actions.begin();) {
+    --it;
+    if (!it->IsApplicable(parent_->state_)) continue;
 
-  while (it_op_ != planner_->operators_.begin() || it_param_ != param_gen_.begin()) {
-    const VAL::operator_* op = *it_op_;
-    if (it_param_ == param_gen_.begin()) {
-      // Move onto next action
-      --it_op_;
-      op = *it_op_;
-
-      // Generate new parameters
-      param_gen_ = ParameterGenerator(planner_->objects_, op->parameters);
-      it_param_ = --param_gen_.end();
-    } else {
-      // Move onto next parameters
-      --it_param_;
-    }
-
-    const Formula& P = GetFormula(planner_->formulas_, planner_->objects_, op->precondition, op->parameters);
-    const std::vector<const VAL::parameter_symbol*>& action_args = *it_param_;
-    if (P(parent_->propositions_, action_args)) {
-      child_.action_ = Proposition(op->name->getName(), action_args);
-      child_.propositions_ = ApplyEffects(planner_->formulas_, planner_->objects_,
-                                          action_args, op->parameters,
-                                          op->effects, parent_->propositions_);
-      break;
-    }
+    it_action_ = it;
+    child_.action_ = &*it_action_;
+    child_.state_ = it_action_->Apply(parent_->state_);
+    break;
   }
-
   return *this;
 }
 
 bool Planner::Node::iterator::operator==(const iterator& other) const {
-  return it_op_ == planner_->operators_.end() && other.it_op_ == other.planner_->operators_.end();
+  return it_action_ == other.it_action_;
 }
 
 Planner::Node::iterator Planner::Node::begin() const {
   iterator it(this);
   if (it == end()) return it;
 
-  const VAL::operator_* op = *it.it_op_;
-  const Formula& P = GetFormula(planner_->formulas_, planner_->objects_, op->precondition, op->parameters);
-  const std::vector<const VAL::parameter_symbol*>& action_args = *it.it_param_;
-  if (P(propositions_, action_args)) {
-    it.child_.action_ = Proposition(op->name->getName(), action_args);
-    it.child_.propositions_ = ApplyEffects(planner_->formulas_, planner_->objects_,
-                                           action_args, op->parameters,
-                                           op->effects, propositions_);
+  const GroundAction& action = *it.it_action_;
+  if (action.IsApplicable(state_)) {
+    it.child_.action_ = &action;
+    it.child_.state_ = action.Apply(state_);
     return it;
   }
   ++it;
@@ -186,13 +126,12 @@ Planner::Node::iterator Planner::Node::begin() const {
 
 Planner::Node::iterator Planner::Node::end() const {
   iterator it(this);
-  it.it_op_ = planner_->operators_.end();
+  it.it_action_ = planner_->actions_.end();
   return it;
 }
 
 Planner::Node::operator bool() const {
-  const Formula& G = GetFormula(planner_->formulas_, planner_->objects_, planner_->goal_, &planner_->goal_params_);
-  return G(propositions_, planner_->goal_args_);
+  return planner_->goal_.IsSatisfied(state_);
 }
 
 }  // namespace logic_opt
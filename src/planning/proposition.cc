@@ -9,7 +9,10 @@
 
 #include "logic_opt/planning/proposition.h"
 
-#include <sstream>  // std::stringstream
+#include <mutex>          // std::lock_guard, std::mutex
+#include <sstream>        // std::stringstream
+#include <unordered_map>  // std::unordered_map
+#include <unordered_set>  // std::unordered_set
 
 namespace {
 
@@ -27,9 +30,40 @@ bool IsSubtype(const VAL::pddl_type* subtype, const VAL::pddl_type* supertype) {
 
 namespace logic_opt {
 
+const std::string* Proposition::InternPredicate(const std::string& name_predicate) {
+  // Elements of unordered sets are never moved
+  static std::unordered_set<std::string> predicates;
+  static std::mutex mtx_predicates;
+
+  // Threads only lock the shared table the first time they see a predicate
+  thread_local std::unordered_map<std::string, const std::string*> cache;
+  auto it = cache.find(name_predicate);
+  if (it != cache.end()) return it->second;
+
+  const std::string* predicate;
+  {
+    std::lock_guard<std::mutex> lock(mtx_predicates);
+    predicate = &*predicates.insert(name_predicate).first;
+  }
+  cache.emplace(name_predicate, predicate);
+  return predicate;
+}
+
+size_t Proposition::ComputeHash() const {
+  std::hash<const void*> hash_ptr;
+  size_t hash = hash_ptr(predicate_);
+  for (const VAL::parameter_symbol* var : variables_) {
+    hash ^= hash_ptr(var) + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+  }
+  return hash;
+}
+
+Proposition::Proposition() : predicate_(InternPredicate("")), hash_(ComputeHash()) {}
+
 Proposition::Proposition(const VAL::proposition* predicate,
                          std::vector<const VAL::parameter_symbol*>&& a_variables)
-    : predicate_(predicate->head->getName()), variables_(std::move(a_variables)) {
+    : predicate_(InternPredicate(predicate->head->getName())),
+      variables_(std::move(a_variables)), hash_(ComputeHash()) {
 
   // Check number of arguments
   if (predicate->args->size() != variables_.size()) {
@@ -70,26 +104,22 @@ Proposition::Proposition(const VAL::proposition* predicate,
 
 Proposition::Proposition(const std::string& name_predicate,
                          std::vector<const VAL::parameter_symbol*>&& a_variables)
-    : predicate_(name_predicate), variables_(std::move(a_variables)) {}
+    : predicate_(InternPredicate(name_predicate)), variables_(std::move(a_variables)),
+      hash_(ComputeHash()) {}
 
 Proposition::Proposition(const std::string& name_predicate,
                          const std::vector<const VAL::parameter_symbol*>& a_variables)
-    : predicate_(name_predicate), variables_(a_variables) {}
+    : predicate_(InternPredicate(name_predicate)), variables_(a_variables),
+      hash_(ComputeHash()) {}
 
 bool Proposition::operator<(const Proposition& rhs) const {
-  if (predicate_ != rhs.predicate_) return predicate_ < rhs.predicate_;
-  for (size_t i = 0; i < variables_.size(); i++) {
-    if (variables_[i] != rhs.variables_[i]) return variables_[i] < rhs.variables_[i];
-  }
-  return false;
+  // Keep predicates in alphabetical order
+  if (predicate_ != rhs.predicate_) return *predicate_ < *rhs.predicate_;
+  return variables_ < rhs.variables_;
 }
 
 bool Proposition::operator==(const Proposition& rhs) const {
-  if (predicate_ != rhs.predicate_) return false;
-  for (size_t i = 0; i < variables_.size(); i++) {
-    if (variables_[i] != rhs.variables_[i]) return false;
-  }
-  return true;
+  return hash_ == rhs.hash_ && predicate_ == rhs.predicate_ && variables_ == rhs.variables_;
 }
 
 bool Proposition::operator!=(const Proposition& rhs) const {
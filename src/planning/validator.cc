@@ -11,6 +11,7 @@
 
 #include <algorithm>  // std::replace
 #include <sstream>    // std::stringstream
+#include <stdexcept>  // std::invalid_argument
 
 #include "ptree.h"
 
@@ -54,19 +55,41 @@ std::set<Proposition> CreateInitialPropositions(const VAL::effect_lists* initial
   return propositions;
 }
 
-// TODO: Remove
-std::set<std::string> ConvertState(const std::set<Proposition>& propositions) {
-  std::set<std::string> state;
-  for (const Proposition& prop : propositions) {
+std::vector<std::string> RenderAtoms(const AtomIndex& atoms) {
+  std::vector<std::string> str_atoms;
+  str_atoms.reserve(atoms.size());
+  for (size_t i = 0; i < atoms.size(); i++) {
     std::stringstream ss;
-    ss << prop.predicate() << "(";
-    std::string delimiter;
-    for (const VAL::parameter_symbol* var : prop.variables()) {
-      ss << delimiter << var->getName();
-      if (delimiter.empty()) delimiter = ", ";
-    }
-    ss << ")";
-    state.insert(ss.str());
+    ss << atoms.atom(i);
+    str_atoms.push_back(ss.str());
+  }
+  return str_atoms;
+}
+
+std::set<std::string> RenderEqualities(const std::vector<const VAL::parameter_symbol*>& objects) {
+  // Equality is not part of the atom index
+  std::set<std::string> str_equalities;
+  for (const VAL::parameter_symbol* object : objects) {
+    str_equalities.insert("=(" + object->getName() + ", " + object->getName() + ")");
+  }
+  return str_equalities;
+}
+
+std::unordered_map<std::string, size_t> IndexStrings(const std::vector<std::string>& strings) {
+  std::unordered_map<std::string, size_t> idx_strings;
+  idx_strings.reserve(strings.size());
+  for (size_t i = 0; i < strings.size(); i++) {
+    idx_strings.emplace(strings[i], i);
+  }
+  return idx_strings;
+}
+
+std::set<std::string> ConvertState(const std::vector<std::string>& str_atoms,
+                                   const std::set<std::string>& str_equalities,
+                                   const State& atom_state) {
+  std::set<std::string> state(str_equalities);
+  for (size_t i = 0; i < str_atoms.size(); i++) {
+    if (atom_state.Contains(i)) state.insert(str_atoms[i]);
   }
   return state;
 }
@@ -78,9 +101,16 @@ Validator::Validator(const std::string& domain_pddl, const std::string& problem_
       domain_(analysis_->the_domain),
       problem_(analysis_->the_problem),
       objects_(CreateObjectsMap(domain_->constants, problem_->objects)),
+      atoms_(std::make_shared<const AtomIndex>(domain_, objects_)),
       list_objects_(CreateGoalParams(objects_)),
       vec_objects_(list_objects_.begin(), list_objects_.end()),
-      initial_state_(ConvertState(CreateInitialPropositions(problem_->initial_state, domain_->constants, problem_->objects))) {}
+      str_atoms_(RenderAtoms(*atoms_)),
+      str_equalities_(RenderEqualities(vec_objects_)),
+      idx_str_atoms_(IndexStrings(str_atoms_)),
+      initial_state_(ConvertState(str_atoms_, str_equalities_,
+                                  atoms_->CreateState(CreateInitialPropositions(problem_->initial_state,
+                                                                                domain_->constants,
+                                                                                problem_->objects)))) {}
 
 std::string ParsePredicate(const std::string& proposition) {
   return proposition.substr(0, proposition.find_first_of('('));
@@ -103,31 +133,51 @@ Proposition Validator::GetProposition(const std::string& proposition) const {
   return Proposition(name_predicate, std::move(val_args));
 }
 
-std::set<Proposition> Validator::GetPropositions(const std::set<std::string>& state) const {
-  std::set<Proposition> propositions;
+State Validator::GetState(const std::set<std::string>& state) const {
+  State atom_state = atoms_->CreateState();
+
+  // Parse propositions that are not in canonical form. Propositions that
+  // are not atoms of the problem can never affect a formula, so skip them.
   for (const std::string& proposition : state) {
-    propositions.insert(GetProposition(proposition));
+    auto it = idx_str_atoms_.find(proposition);
+    if (it != idx_str_atoms_.end()) {
+      atom_state.Add(it->second);
+    } else if (str_equalities_.find(proposition) == str_equalities_.end()) {
+      const size_t idx_atom = atoms_->AtomId(GetProposition(proposition));
+      if (idx_atom != AtomIndex::kNotFound) atom_state.Add(idx_atom);
+    }
   }
-  return propositions;
+  return atom_state;
+}
+
+const GroundAction& Validator::GetGroundAction(const std::string& action_call) const {
+  const std::string name_action = ParsePredicate(action_call);
+  const Action action(domain_, name_action);
+  if (action.symbol() == nullptr) {
+    throw std::invalid_argument("Validator::GetGroundAction(): Action " + name_action + " does not exist.");
+  }
+
+  auto key = std::make_pair(action.symbol(), GetValArguments(action_call));
+  auto it = ground_actions_.find(key);
+  if (it == ground_actions_.end()) {
+    GroundAction ground_action = GroundOperator(domain_, *atoms_, key.first, key.second);
+    it = ground_actions_.emplace(std::move(key), std::move(ground_action)).first;
+  }
+  return it->second;
 }
 
 std::set<std::string> Validator::NextState(const std::set<std::string>& state,
                                            const std::string& action_call) const {
   // if (!IsValidAction(state, action_call)) throw std::runtime_error("TODO");
-  const std::set<Proposition> propositions = GetPropositions(state);
-  const std::string name_action = ParsePredicate(action_call);
-  const Action action(domain_, name_action);
-  const std::vector<const VAL::parameter_symbol*> action_args = GetValArguments(action_call);
-  const std::set<Proposition> post = ApplyEffects(formulas_, objects_,
-                                                  action_args, action.symbol()->parameters,
-                                                  action.symbol()->effects, propositions);
-  const std::set<std::string> next_state = ConvertState(post);
+  const State atom_state = GetState(state);
+  const State post = GetGroundAction(action_call).Apply(atom_state);
+  const std::set<std::string> next_state = ConvertState(str_atoms_, str_equalities_, post);
   return next_state;
 }
 
 bool Validator::IsValidAction(const std::set<std::string>& state,
                               const std::string& action_call) const {
-  const std::set<Proposition> propositions = GetPropositions(state);
+  const State atom_state = GetState(state);
   const std::string name_action = ParsePredicate(action_call);
   const Action action(domain_, name_action);
   if (action.symbol() == nullptr) return false;
@@ -137,9 +187,9 @@ bool Validator::IsValidAction(const std::set<std::string>& state,
 
   // TODO: Implement formula using Action
   try {
-    const Formula& P = GetFormula(formulas_, objects_,
+    const Formula& P = GetFormula(formulas_, atoms_,
                                   action.symbol()->precondition, action.symbol()->parameters);
-    return P(propositions, action_args);
+    return P(atom_state, action_args);
   } catch (...) {
     return false;
   }
@@ -152,9 +202,9 @@ bool Validator::IsValidTuple(const std::set<std::string>& state,
 }
 
 bool Validator::IsGoalSatisfied(const std::set<std::string>& state) const {
-  const std::set<Proposition> propositions = GetPropositions(state);
-  const Formula& G = GetFormula(formulas_, objects_, problem_->the_goal, &list_objects_);
-  return G(propositions, vec_objects_);
+  const State atom_state = GetState(state);
+  const Formula& G = GetFormula(formulas_, atoms_, problem_->the_goal, &list_objects_);
+  return G(atom_state, vec_objects_);
 }
 
 bool Validator::IsValidPlan(const std::vector<std::string>& actions) const {
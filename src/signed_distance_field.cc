@@ -0,0 +1,197 @@
+/**
+ * signed_distance_field.cc
+ *
+ * Copyright 2026. All Rights Reserved.
+ *
+ * Created: October 17, 2026
+ * Authors: Toki Migimatsu
+ */
+
+#include "logic_opt/signed_distance_field.h"
+
+#include <cstdio>     // std::remove, std::rename
+#include <fstream>    // std::ifstream, std::ofstream
+#include <iomanip>    // std::hex, std::setfill, std::setw
+#include <iostream>   // std::cerr
+#include <iterator>   // std::istreambuf_iterator
+#include <sstream>    // std::stringstream
+#include <stdexcept>  // std::invalid_argument
+#include <string>     // std::to_string
+#include <unistd.h>   // ::getpid
+
+namespace {
+
+// Increment when the file format or the collision shapes change
+const uint64_t kCacheVersion = 1;
+const uint64_t kMagic = 0x3146445354504f4cULL;  // "LOPTSDF1"
+
+// FNV-1a
+void Hash(const void* data, size_t size, uint64_t& hash) {
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+  for (size_t i = 0; i < size; i++) {
+    hash ^= bytes[i];
+    hash *= 0x100000001b3ULL;
+  }
+}
+
+uint64_t HashGeometry(const std::vector<spatial_dyn::Graphics>& graphics,
+                      double resolution, double margin) {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  Hash(&kCacheVersion, sizeof(kCacheVersion), hash);
+  Hash(&resolution, sizeof(resolution), hash);
+  Hash(&margin, sizeof(margin), hash);
+  for (const spatial_dyn::Graphics& g : graphics) {
+    const spatial_dyn::Graphics::Geometry& geometry = g.geometry;
+    Hash(&geometry.type, sizeof(geometry.type), hash);
+    Hash(g.T_to_parent.matrix().data(), 16 * sizeof(double), hash);
+    Hash(geometry.scale.data(), 3 * sizeof(double), hash);
+    Hash(&geometry.length, sizeof(geometry.length), hash);
+    Hash(&geometry.radius, sizeof(geometry.radius), hash);
+    Hash(geometry.mesh.data(), geometry.mesh.size(), hash);
+
+    // Meshes may be edited in place, so hash the file contents as well
+    if (geometry.type == spatial_dyn::Graphics::Geometry::Type::kMesh) {
+      std::ifstream file(geometry.mesh, std::ios::binary);
+      const std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+      Hash(data.data(), data.size(), hash);
+    }
+  }
+  return hash;
+}
+
+}  // namespace
+
+namespace logic_opt {
+
+constexpr double SignedDistanceField::kDefaultResolution;
+constexpr double SignedDistanceField::kDefaultMargin;
+
+SignedDistanceField::SignedDistanceField(const ncollide3d::shape::Shape& shape,
+                                         double resolution, double margin)
+    : resolution_(resolution) {
+  if (resolution <= 0. || margin < 0.) {
+    throw std::invalid_argument("SignedDistanceField(): Resolution must be positive and margin non-negative.");
+  }
+
+  const auto aabb = shape.aabb(Eigen::Isometry3d::Identity());
+  origin_ = aabb.mins().array() - margin;
+  const Eigen::Vector3d maxs = aabb.maxs().array() + margin;
+  size_ = (((maxs - origin_) / resolution).array().ceil().cast<int>() + 1).max(2);
+
+  // Sample the distance to the boundary at each grid point
+  values_.resize(size_.prod());
+  for (int z = 0; z < size_(2); z++) {
+    for (int y = 0; y < size_(1); y++) {
+      for (int x = 0; x < size_(0); x++) {
+        const Eigen::Vector3d point = origin_ + resolution * Eigen::Vector3d(x, y, z);
+        const auto projection = shape.project_point(Eigen::Isometry3d::Identity(), point, false);
+        const double dist = (point - projection.point).norm();
+        values_[Index(x, y, z)] = projection.is_inside ? -dist : dist;
+      }
+    }
+  }
+}
+
+std::shared_ptr<const SignedDistanceField>
+SignedDistanceField::LoadOrCompute(const std::vector<spatial_dyn::Graphics>& graphics,
+                                   const ncollide3d::shape::Shape& shape,
+                                   const std::string& cache_dir,
+                                   double resolution, double margin) {
+  const uint64_t key = HashGeometry(graphics, resolution, margin);
+  std::stringstream ss;
+  ss << cache_dir << "/" << std::hex << std::setfill('0') << std::setw(16) << key << ".sdf";
+  const std::string filename = ss.str();
+
+  std::unique_ptr<SignedDistanceField> sdf = Load(filename, key);
+  if (sdf) return sdf;
+
+  sdf = std::make_unique<SignedDistanceField>(shape, resolution, margin);
+  sdf->Save(filename, key);
+  return sdf;
+}
+
+std::unique_ptr<SignedDistanceField> SignedDistanceField::Load(const std::string& filename,
+                                                               uint64_t key) {
+  std::ifstream file(filename, std::ios::binary);
+  if (!file) return nullptr;
+
+  uint64_t magic = 0;
+  uint64_t file_key = 0;
+  file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+  file.read(reinterpret_cast<char*>(&file_key), sizeof(file_key));
+  if (!file || magic != kMagic || file_key != key) return nullptr;
+
+  std::unique_ptr<SignedDistanceField> sdf(new SignedDistanceField());
+  file.read(reinterpret_cast<char*>(&sdf->resolution_), sizeof(sdf->resolution_));
+  file.read(reinterpret_cast<char*>(sdf->origin_.data()), 3 * sizeof(double));
+  file.read(reinterpret_cast<char*>(sdf->size_.data()), 3 * sizeof(int));
+  if (!file || (sdf->size_ < 2).any()) return nullptr;
+
+  sdf->values_.resize(sdf->size_.prod());
+  file.read(reinterpret_cast<char*>(sdf->values_.data()), sdf->values_.size() * sizeof(float));
+  if (!file) return nullptr;
+  return sdf;
+}
+
+void SignedDistanceField::Save(const std::string& filename, uint64_t key) const {
+  // Write to a temporary file first so that readers never see partial files
+  const std::string filename_tmp = filename + "." + std::to_string(::getpid()) + ".tmp";
+  {
+    std::ofstream file(filename_tmp, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(&kMagic), sizeof(kMagic));
+    file.write(reinterpret_cast<const char*>(&key), sizeof(key));
+    file.write(reinterpret_cast<const char*>(&resolution_), sizeof(resolution_));
+    file.write(reinterpret_cast<const char*>(origin_.data()), 3 * sizeof(double));
+    file.write(reinterpret_cast<const char*>(size_.data()), 3 * sizeof(int));
+    file.write(reinterpret_cast<const char*>(values_.data()), values_.size() * sizeof(float));
+    if (!file) {
+      // The field is still usable without the cache
+      std::cerr << "SignedDistanceField::Save(): Failed to write " << filename_tmp << "." << std::endl;
+      std::remove(filename_tmp.c_str());
+      return;
+    }
+  }
+  if (std::rename(filename_tmp.c_str(), filename.c_str()) != 0) {
+    std::cerr << "SignedDistanceField::Save(): Failed to rename " << filename_tmp << "." << std::endl;
+    std::remove(filename_tmp.c_str());
+  }
+}
+
+double SignedDistanceField::Distance(const Eigen::Vector3d& point, Eigen::Vector3d* gradient) const {
+  // Find the grid cell containing the point, clamped to the grid
+  const Eigen::Array3d x = (point - origin_).array() / resolution_;
+  const Eigen::Array3d x_clamped = x.max(0.).min((size_ - 1).cast<double>());
+  const Eigen::Array3i idx = x_clamped.floor().cast<int>().min(size_ - 2);
+  const Eigen::Array3d f = x_clamped - idx.cast<double>();
+
+  // Trilinear interpolation of the corners of the cell
+  double dist = 0.;
+  Eigen::Vector3d grad = Eigen::Vector3d::Zero();
+  for (int k = 0; k < 8; k++) {
+    const Eigen::Array3i offset(k & 1, (k >> 1) & 1, (k >> 2) & 1);
+    const Eigen::Array3i i = idx + offset;
+    const double value = values_[Index(i(0), i(1), i(2))];
+
+    // Corner weights along each axis and their derivatives
+    const Eigen::Array3d w = (offset == 1).select(f, 1. - f);
+    const Eigen::Array3d dw = (offset == 1).select(Eigen::Array3d::Ones(), -Eigen::Array3d::Ones());
+    dist += w.prod() * value;
+    grad(0) += dw(0) * w(1) * w(2) * value;
+    grad(1) += w(0) * dw(1) * w(2) * value;
+    grad(2) += w(0) * w(1) * dw(2) * value;
+  }
+  grad /= resolution_;
+
+  // Points outside the grid are at least margin away from the shape
+  const Eigen::Vector3d dx = resolution_ * (x - x_clamped).matrix();
+  const double dist_outside = dx.norm();
+  if (dist_outside > 0.) {
+    dist += dist_outside;
+    grad = dx / dist_outside;
+  }
+
+  if (gradient != nullptr) *gradient = grad;
+  return dist;
+}
+
+}  // namespace logic_opt
@@ -8,14 +8,67 @@
  */
 
 #include "logic_opt/world.h"
+#include "logic_opt/convex_decomposition.h"
 #include "logic_opt/optimization/constraints.h"
 
+#include <algorithm>  // std::any_of
 #include <cmath>      // std::fabs
+#include <exception>  // std::out_of_range
 
 #include <ctrl_utils/string.h>
 
 namespace logic_opt {
 
+constexpr int FrameTree::kNoParent;
+
+size_t FrameTree::id(const std::string& name) const {
+  auto it = index_->ids.find(name);
+  if (it == index_->ids.end()) {
+    throw std::out_of_range("FrameTree::id(): frame \"" + name + "\" does not exist.");
+  }
+  return it->second;
+}
+
+std::optional<std::string> FrameTree::parent(const std::string& name) const {
+  const int id_parent = parent(id(name));
+  if (id_parent == kNoParent) return {};
+  return index_->names[id_parent];
+}
+
+std::vector<std::pair<std::string, Frame>> FrameTree::values() const {
+  std::vector<std::pair<std::string, Frame>> frames;
+  frames.reserve(size());
+  for (size_t i = 0; i < size(); i++) {
+    frames.emplace_back(index_->names[i], frame(i));
+  }
+  return frames;
+}
+
+std::vector<std::pair<const std::string, Frame>> FrameTree::ancestors(const std::string& name) const {
+  std::vector<std::pair<const std::string, Frame>> frames;
+  for (int i = id(name); i != kNoParent; i = topology_->parents[i]) {
+    frames.emplace_back(index_->names[i], frame(i));
+  }
+  return frames;
+}
+
+std::vector<std::pair<const std::string, Frame>> FrameTree::descendants(const std::string& name) const {
+  const size_t id_ancestor = id(name);
+  std::vector<std::pair<const std::string, Frame>> frames;
+  for (size_t i = 0; i < size(); i++) {
+    if (!is_ancestor(id_ancestor, i)) continue;
+    frames.emplace_back(index_->names[i], frame(i));
+  }
+  return frames;
+}
+
+bool FrameTree::is_ancestor(size_t id_ancestor, size_t id_descendant) const {
+  for (int i = id_descendant; i != kNoParent; i = topology_->parents[i]) {
+    if (i == static_cast<int>(id_ancestor)) return true;
+  }
+  return false;
+}
+
 template<>
 Eigen::Isometry3d ConvertIsometry<3>(const Eigen::Isometry3d& T) {
   return T;
@@ -51,6 +104,34 @@ Object<3>::MakeCollision(const spatial_dyn::Graphics::Geometry& geometry) {
   }
 }
 
+template<>
+void Object<3>::DecomposeMeshes(double max_concavity, size_t max_parts) {
+  const bool has_mesh = std::any_of(graphics.begin(), graphics.end(), [](const spatial_dyn::Graphics& g) {
+    return g.geometry.type == spatial_dyn::Graphics::Geometry::Type::kMesh;
+  });
+  if (!has_mesh) return;
+
+  auto MakeConvexCollision = [max_concavity, max_parts](const spatial_dyn::Graphics::Geometry& geometry)
+      -> std::unique_ptr<ncollide3d::shape::Shape> {
+    if (geometry.type != spatial_dyn::Graphics::Geometry::Type::kMesh) return MakeCollision(geometry);
+    const auto decomposition = ConvexDecomposition::LoadOrCompute(geometry.mesh, max_concavity, max_parts);
+    if (decomposition) return decomposition->MakeShape();
+    return MakeCollision(geometry);
+  };
+
+  if (graphics.size() == 1) {
+    collision = MakeConvexCollision(graphics[0].geometry);
+    return;
+  }
+
+  ncollide3d::shape::ShapeVector shapes;
+  shapes.reserve(graphics.size());
+  for (const spatial_dyn::Graphics& g : graphics) {
+    shapes.emplace_back(g.T_to_parent, MakeConvexCollision(g.geometry));
+  }
+  collision = std::make_unique<ncollide3d::shape::Compound>(std::move(shapes));
+}
+
 template<>
 std::unique_ptr<ncollide2d::shape::Shape>
 Object<2>::MakeCollision(const spatial_dyn::Graphics::Geometry& geometry) {
@@ -0,0 +1,138 @@
+/**
+ * closed_set_test.cc
+ *
+ * Copyright 2026. All Rights Reserved.
+ *
+ * Created: October 17, 2026
+ * Authors: Toki Migimatsu
+ */
+
+#include "logic_opt/planning/breadth_first_search.h"
+#include "logic_opt/planning/closed_set.h"
+#include "logic_opt/planning/depth_first_search.h"
+
+#include <stdexcept>  // std::invalid_argument
+#include <vector>     // std::vector
+
+#include "test_utils.h"
+
+namespace {
+
+/**
+ * Node of the graph 0 -> {1, 2}, 1 -> {2, 3}, 2 -> {3} with goal 3.
+ */
+class GraphNode {
+
+ public:
+
+  explicit GraphNode(int state) : state_(state) {}
+
+  int state() const { return state_; }
+
+  explicit operator bool() const { return state_ == 3; }
+
+  std::vector<GraphNode>::const_iterator begin() const { return Children().begin(); }
+  std::vector<GraphNode>::const_iterator end() const { return Children().end(); }
+
+ private:
+
+  const std::vector<GraphNode>& Children() const {
+    static const std::vector<std::vector<GraphNode>> kChildren = {
+      { GraphNode(1), GraphNode(2) },
+      { GraphNode(2), GraphNode(3) },
+      { GraphNode(3) },
+      {}
+    };
+    return kChildren[state_];
+  }
+
+  int state_;
+
+};
+
+template<template<typename> class SearchT>
+std::vector<std::vector<int>> Search(logic_opt::DuplicateDetection mode) {
+  const GraphNode root(0);
+  SearchT<GraphNode> search(root, 3, mode);
+  std::vector<std::vector<int>> plans;
+  for (const std::vector<GraphNode>& plan : search) {
+    std::vector<int> states;
+    for (const GraphNode& node : plan) states.push_back(node.state());
+    plans.push_back(std::move(states));
+  }
+  return plans;
+}
+
+void TestInsert() {
+  using logic_opt::ClosedSet;
+  using logic_opt::DuplicateDetection;
+
+  ClosedSet<GraphNode> none(DuplicateDetection::kNone);
+  EXPECT(none.Insert(GraphNode(1), 1));
+  EXPECT(none.Insert(GraphNode(1), 1));
+
+  ClosedSet<GraphNode> first_visit(DuplicateDetection::kFirstVisit);
+  EXPECT(first_visit.Insert(GraphNode(1), 2));
+  EXPECT(!first_visit.Insert(GraphNode(1), 2));
+  EXPECT(!first_visit.Insert(GraphNode(1), 1));
+  EXPECT(first_visit.Insert(GraphNode(2), 3));
+
+  ClosedSet<GraphNode> best_depth(DuplicateDetection::kBestDepth);
+  EXPECT(best_depth.Insert(GraphNode(1), 2));
+  EXPECT(best_depth.Insert(GraphNode(1), 2));
+  EXPECT(!best_depth.Insert(GraphNode(1), 3));
+  EXPECT(best_depth.Insert(GraphNode(1), 1));
+  EXPECT(!best_depth.Insert(GraphNode(1), 2));
+
+  best_depth.Clear();
+  EXPECT(best_depth.Insert(GraphNode(1), 2));
+}
+
+void TestBreadthFirstSearch() {
+  using logic_opt::BreadthFirstSearch;
+  using logic_opt::DuplicateDetection;
+
+  // Every path to the goal, including the last one found
+  const std::vector<std::vector<int>> plans_none = Search<BreadthFirstSearch>(DuplicateDetection::kNone);
+  EXPECT(plans_none == std::vector<std::vector<int>>({ { 0, 1, 3 }, { 0, 2, 3 }, { 0, 1, 2, 3 } }));
+
+  // A single path per state
+  const std::vector<std::vector<int>> plans_first = Search<BreadthFirstSearch>(DuplicateDetection::kFirstVisit);
+  EXPECT(plans_first == std::vector<std::vector<int>>({ { 0, 1, 3 } }));
+
+  // Every shortest path, without the detour 0 -> 1 -> 2 -> 3
+  const std::vector<std::vector<int>> plans_best = Search<BreadthFirstSearch>(DuplicateDetection::kBestDepth);
+  EXPECT(plans_best == std::vector<std::vector<int>>({ { 0, 1, 3 }, { 0, 2, 3 } }));
+}
+
+void TestDepthFirstSearch() {
+  using logic_opt::DepthFirstSearch;
+  using logic_opt::DuplicateDetection;
+
+  EXPECT(Search<DepthFirstSearch>(DuplicateDetection::kNone).size() == 3);
+
+  // Children are visited in reverse, so 2 is first reached at depth 1
+  EXPECT(Search<DepthFirstSearch>(DuplicateDetection::kFirstVisit).size() == 1);
+  EXPECT(Search<DepthFirstSearch>(DuplicateDetection::kBestDepth).size() == 2);
+}
+
+void TestParse() {
+  using logic_opt::DuplicateDetection;
+  using logic_opt::ParseDuplicateDetection;
+
+  EXPECT(ParseDuplicateDetection("none") == DuplicateDetection::kNone);
+  EXPECT(ParseDuplicateDetection("first_visit") == DuplicateDetection::kFirstVisit);
+  EXPECT(ParseDuplicateDetection("best_depth") == DuplicateDetection::kBestDepth);
+  EXPECT_THROW(ParseDuplicateDetection("best"), std::invalid_argument);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  TestInsert();
+  TestBreadthFirstSearch();
+  TestDepthFirstSearch();
+  TestParse();
+
+  return logic_opt::test::Result("closed_set_test");
+}
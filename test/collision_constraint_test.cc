@@ -0,0 +1,126 @@
+/**
+ * collision_constraint_test.cc
+ *
+ * Copyright 2026. All Rights Reserved.
+ *
+ * Created: October 17, 2026
+ * Authors: Toki Migimatsu
+ */
+
+#include "logic_opt/constraints/collision_constraint.h"
+
+#include <map>     // std::map
+#include <memory>  // std::make_shared
+#include <string>  // std::string
+
+#include "test_utils.h"
+
+namespace {
+
+using logic_opt::World3;
+
+/**
+ * The ee holds two balls on either side of its origin, so both its position
+ * and orientation change the penetration depth into the table below.
+ */
+World3 CreateWorld() {
+  auto objects = std::make_shared<std::map<std::string, logic_opt::Object3>>();
+  {
+    spatial_dyn::RigidBody table("table");
+    spatial_dyn::Graphics graphics;
+    graphics.geometry.type = spatial_dyn::Graphics::Geometry::Type::kBox;
+    graphics.geometry.scale = Eigen::Vector3d(0.4, 0.4, 0.4);
+    table.graphics.push_back(std::move(graphics));
+    table.set_T_to_parent(Eigen::Quaterniond::Identity(), Eigen::Vector3d(0., 0., -0.2));
+    objects->emplace(std::string(table.name), std::move(table));
+  }
+  {
+    spatial_dyn::RigidBody ee("ee");
+    for (const double x : { -0.04, 0.04 }) {
+      spatial_dyn::Graphics graphics;
+      graphics.geometry.type = spatial_dyn::Graphics::Geometry::Type::kSphere;
+      graphics.geometry.radius = 0.03;
+      graphics.T_to_parent = Eigen::Translation3d(x, 0., 0.);
+      ee.graphics.push_back(std::move(graphics));
+    }
+    objects->emplace(std::string(ee.name), std::move(ee));
+  }
+
+  World3 world(objects, 1);
+  world.AttachFrame("ee", World3::kWorldFrame, 0);
+  return world;
+}
+
+Eigen::VectorXd FiniteDifferenceJacobian(logic_opt::Constraint& constraint,
+                                         const Eigen::MatrixXd& X) {
+  constraint.set_iterate(logic_opt::Constraint::kNoIterate);
+
+  const double h = 1e-6;
+  Eigen::VectorXd J(World3::kDof);
+  Eigen::VectorXd c_hp(1);
+  Eigen::VectorXd c_hn(1);
+  Eigen::MatrixXd X_h = X;
+  for (size_t i = 0; i < World3::kDof; i++) {
+    X_h(i, 0) = X(i, 0) + h;
+    constraint.Evaluate(X_h, c_hp);
+    X_h(i, 0) = X(i, 0) - h;
+    constraint.Evaluate(X_h, c_hn);
+    X_h(i, 0) = X(i, 0);
+    J(i) = (c_hp(0) - c_hn(0)) / (2. * h);
+  }
+  return J;
+}
+
+bool IsClose(const Eigen::VectorXd& J, const Eigen::VectorXd& J_expected) {
+  return (J - J_expected).norm() <= 1e-4 * J_expected.norm();
+}
+
+void TestPenetration() {
+  World3 world = CreateWorld();
+  logic_opt::CollisionConstraint constraint(world, 0);
+
+  Eigen::MatrixXd X(World3::kDof, 1);
+  X << 0.01, 0.02, 0.02, 0.3, 0.4, 0.1;
+
+  // Penetrating contacts have positive depth
+  Eigen::VectorXd c(1);
+  constraint.Evaluate(X, c);
+  EXPECT(c(0) > 0.);
+
+  Eigen::VectorXd J(World3::kDof);
+  constraint.Jacobian(X, J);
+  const Eigen::VectorXd J_fd = FiniteDifferenceJacobian(constraint, X);
+  EXPECT(J_fd.tail<3>().norm() > 1e-4);
+  EXPECT(IsClose(J, J_fd));
+}
+
+void TestIterates() {
+  World3 world = CreateWorld();
+  logic_opt::CollisionConstraint constraint(world, 0);
+
+  Eigen::MatrixXd X(World3::kDof, 1);
+  Eigen::VectorXd c(1);
+  Eigen::VectorXd J(World3::kDof);
+
+  // Jacobian after Evaluate at the same iterate
+  X << 0.02, -0.01, 0.015, -0.2, 0.3, 0.4;
+  constraint.set_iterate(1);
+  constraint.Evaluate(X, c);
+  constraint.Jacobian(X, J);
+  EXPECT(IsClose(J, FiniteDifferenceJacobian(constraint, X)));
+
+  // Jacobian before Evaluate at a new iterate
+  X << -0.01, 0.01, 0.025, 0.1, -0.5, 0.2;
+  constraint.set_iterate(2);
+  constraint.Jacobian(X, J);
+  EXPECT(IsClose(J, FiniteDifferenceJacobian(constraint, X)));
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  TestPenetration();
+  TestIterates();
+
+  return logic_opt::test::Result("collision_constraint_test");
+}
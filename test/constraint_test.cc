@@ -0,0 +1,300 @@
+/**
+ * constraint_test.cc
+ *
+ * Copyright 2026. All Rights Reserved.
+ *
+ * Created: October 17, 2026
+ * Authors: Toki Migimatsu
+ */
+
+#include "logic_opt/constraints/constraint.h"
+
+#include <cmath>  // std::cos, std::sin
+
+#include "test_utils.h"
+
+namespace {
+
+const size_t kDof = 3;
+const size_t kNumTimesteps = 2;
+
+/**
+ * c0 = x0^2 x4, c1 = sin(x2) + x3^3, where xj is entry j of X in
+ * column-major order.
+ */
+class PolynomialConstraint : public logic_opt::Constraint {
+
+ public:
+
+  PolynomialConstraint() : Constraint(2, 4, 0, kNumTimesteps, "polynomial") {}
+
+  virtual void Evaluate(Eigen::Ref<const Eigen::MatrixXd> X,
+                        Eigen::Ref<Eigen::VectorXd> constraints) override {
+    ComputeError(X, constraints);
+    Constraint::Evaluate(X, constraints);
+  }
+
+  virtual void Jacobian(Eigen::Ref<const Eigen::MatrixXd> X,
+                        Eigen::Ref<Eigen::VectorXd> Jacobian) override {
+    FiniteDifferenceJacobian(X, error_, h_, Jacobian);
+    Constraint::Jacobian(X, Jacobian);
+  }
+
+  virtual void JacobianIndices(Eigen::Ref<Eigen::ArrayXi> idx_i,
+                               Eigen::Ref<Eigen::ArrayXi> idx_j) override {
+    idx_i << 0, 0, 1, 1;
+    idx_j << 0, 4, 2, 3;
+  }
+
+  static Eigen::VectorXd AnalyticJacobian(Eigen::Ref<const Eigen::MatrixXd> X) {
+    const double* x = X.data();
+    Eigen::VectorXd J(4);
+    J << 2. * x[0] * x[4], x[0] * x[0], std::cos(x[2]), 3. * x[3] * x[3];
+    return J;
+  }
+
+  void FiniteDifference(Eigen::Ref<const Eigen::MatrixXd> X, Eigen::Ref<Eigen::VectorXd> Jacobian,
+                        size_t idx_begin, size_t idx_end, const Eigen::VectorXd* error_0 = nullptr) {
+    FiniteDifferenceJacobian(X, error_, h_, Jacobian, idx_begin, idx_end, error_0);
+  }
+
+  size_t num_evaluations = 0;
+
+ private:
+
+  void ComputeError(Eigen::Ref<const Eigen::MatrixXd> X, Eigen::Ref<Eigen::VectorXd> constraints) {
+    const double* x = X.data();
+    constraints(0) = x[0] * x[0] * x[4];
+    constraints(1) = std::sin(x[2]) + x[3] * x[3] * x[3];
+    num_evaluations++;
+  }
+
+  const Eigen::VectorXd h_ = Eigen::VectorXd::Constant(kDof, 1e-5);
+  const ErrorFunction error_ = [this](Eigen::Ref<const Eigen::MatrixXd> X,
+                                      Eigen::Ref<Eigen::VectorXd> constraints) {
+    ComputeError(X, constraints);
+  };
+
+};
+
+/**
+ * c = 0.5 |r| r, with r = x0 + 2 x4 - 0.5.
+ */
+class ResidualConstraint : public logic_opt::Constraint {
+
+ public:
+
+  ResidualConstraint() : Constraint(1, 2, 0, kNumTimesteps, "residual") {}
+
+  virtual void Evaluate(Eigen::Ref<const Eigen::MatrixXd> X,
+                        Eigen::Ref<Eigen::VectorXd> constraints) override {
+    const double r = Residual(X);
+    constraints(0) = 0.5 * std::abs(r) * r;
+    num_evaluations++;
+    Constraint::Evaluate(X, constraints);
+  }
+
+  virtual void Jacobian(Eigen::Ref<const Eigen::MatrixXd> X,
+                        Eigen::Ref<Eigen::VectorXd> Jacobian) override {
+    const double r = Residual(X);
+    Jacobian << std::abs(r), 2. * std::abs(r);
+    num_jacobians++;
+    Constraint::Jacobian(X, Jacobian);
+  }
+
+  virtual void JacobianIndices(Eigen::Ref<Eigen::ArrayXi> idx_i,
+                               Eigen::Ref<Eigen::ArrayXi> idx_j) override {
+    idx_j << 0, 4;
+  }
+
+  virtual void Hessian(Eigen::Ref<const Eigen::MatrixXd> X,
+                       Eigen::Ref<const Eigen::VectorXd> lambda,
+                       Eigen::Ref<Eigen::SparseMatrix<double>> Hessian) override {
+    GaussNewtonHessian(X, lambda, Hessian);
+  }
+
+  virtual void HessianStructure(Eigen::SparseMatrix<bool>& Hessian) override {
+    GaussNewtonHessianStructure(Hessian);
+  }
+
+  static double Residual(Eigen::Ref<const Eigen::MatrixXd> X) {
+    return X.data()[0] + 2. * X.data()[4] - 0.5;
+  }
+
+  size_t num_evaluations = 0;
+  size_t num_jacobians = 0;
+
+};
+
+/**
+ * Evaluate the Hessian into a sparse matrix with the constraint's structure,
+ * the way the Ipopt wrapper does.
+ */
+Eigen::MatrixXd EvaluateHessian(logic_opt::Constraint& constraint,
+                                Eigen::Ref<const Eigen::MatrixXd> X, double lambda) {
+  Eigen::SparseMatrix<bool> structure(X.size(), X.size());
+  constraint.HessianStructure(structure);
+  structure.makeCompressed();
+
+  Eigen::VectorXd values = Eigen::VectorXd::Zero(structure.nonZeros());
+  Eigen::Map<Eigen::SparseMatrix<double>> H(X.size(), X.size(), structure.nonZeros(),
+                                            structure.outerIndexPtr(), structure.innerIndexPtr(),
+                                            values.data());
+  const Eigen::VectorXd Lambda = Eigen::VectorXd::Constant(constraint.num_constraints(), lambda);
+  constraint.Hessian(X, Lambda, H);
+  return Eigen::MatrixXd(H);
+}
+
+Eigen::MatrixXd RandomX() {
+  return Eigen::MatrixXd::Random(kDof, kNumTimesteps);
+}
+
+void TestCentralDifferences() {
+  PolynomialConstraint constraint;
+  const Eigen::MatrixXd X = RandomX();
+
+  Eigen::VectorXd J(constraint.len_jacobian());
+  constraint.Jacobian(X, J);
+  EXPECT(J.isApprox(PolynomialConstraint::AnalyticJacobian(X), 1e-6));
+
+  // Two evaluations per variable
+  EXPECT(constraint.num_evaluations == 8);
+}
+
+void TestForwardDifferences() {
+  PolynomialConstraint constraint;
+  const Eigen::MatrixXd X = RandomX();
+
+  Eigen::VectorXd error_0(constraint.num_constraints());
+  constraint.Evaluate(X, error_0);
+  constraint.num_evaluations = 0;
+
+  Eigen::VectorXd J(constraint.len_jacobian());
+  constraint.FiniteDifference(X, J, 0, constraint.len_jacobian(), &error_0);
+  EXPECT((J - PolynomialConstraint::AnalyticJacobian(X)).cwiseAbs().maxCoeff() < 1e-4);
+
+  // One evaluation per variable
+  EXPECT(constraint.num_evaluations == 4);
+}
+
+void TestEntryRange() {
+  PolynomialConstraint constraint;
+  const Eigen::MatrixXd X = RandomX();
+  const Eigen::VectorXd J_analytic = PolynomialConstraint::AnalyticJacobian(X);
+
+  // Only entries [1, 3) are written, perturbing only their variables
+  Eigen::VectorXd J = Eigen::VectorXd::Constant(constraint.len_jacobian(), 42.);
+  constraint.FiniteDifference(X, J, 1, 3);
+  EXPECT(J(0) == 42.);
+  EXPECT_NEAR(J(1), J_analytic(1), 1e-6);
+  EXPECT_NEAR(J(2), J_analytic(2), 1e-6);
+  EXPECT(J(3) == 42.);
+  EXPECT(constraint.num_evaluations == 4);
+
+  // Ranges past the end are clipped
+  J.setConstant(42.);
+  constraint.FiniteDifference(X, J, 3, 100);
+  EXPECT(J.head<3>() == Eigen::Vector3d::Constant(42.));
+  EXPECT_NEAR(J(3), J_analytic(3), 1e-6);
+}
+
+void TestIterates() {
+  PolynomialConstraint constraint;
+  Eigen::VectorXd J(constraint.len_jacobian());
+
+  // The perturbation buffer follows X across iterates
+  for (size_t iterate = 1; iterate <= 3; iterate++) {
+    const Eigen::MatrixXd X = RandomX();
+    constraint.set_iterate(iterate);
+    constraint.Jacobian(X, J);
+    EXPECT(J.isApprox(PolynomialConstraint::AnalyticJacobian(X), 1e-6));
+
+    // Repeated calls at the same iterate reuse the buffer
+    constraint.Jacobian(X, J);
+    EXPECT(J.isApprox(PolynomialConstraint::AnalyticJacobian(X), 1e-6));
+  }
+
+  // Without iterates, the buffer is copied on every call
+  constraint.set_iterate(logic_opt::Constraint::kNoIterate);
+  for (size_t i = 0; i < 3; i++) {
+    const Eigen::MatrixXd X = RandomX();
+    constraint.Jacobian(X, J);
+    EXPECT(J.isApprox(PolynomialConstraint::AnalyticJacobian(X), 1e-6));
+  }
+}
+
+void TestGaussNewtonHessian() {
+  ResidualConstraint constraint;
+  const double lambda = 0.7;
+
+  // lambda * sign(r) * dr/dX^T * dr/dX, lower triangle only
+  for (const double sign : { 1., -1. }) {
+    Eigen::MatrixXd X = RandomX();
+    X.data()[0] += sign * 10.;
+    const Eigen::MatrixXd H = EvaluateHessian(constraint, X, lambda);
+
+    Eigen::MatrixXd H_expected = Eigen::MatrixXd::Zero(X.size(), X.size());
+    H_expected(0, 0) = sign * lambda;
+    H_expected(4, 0) = sign * lambda * 2.;
+    H_expected(4, 4) = sign * lambda * 4.;
+    EXPECT(H.isApprox(H_expected, 1e-12));
+  }
+
+  // No curvature at r = 0
+  Eigen::MatrixXd X = Eigen::MatrixXd::Zero(kDof, kNumTimesteps);
+  X.data()[0] = 0.5;
+  EXPECT(EvaluateHessian(constraint, X, lambda).isZero());
+}
+
+void TestGaussNewtonCache() {
+  ResidualConstraint constraint;
+  Eigen::VectorXd c(constraint.num_constraints());
+  Eigen::VectorXd J(constraint.len_jacobian());
+
+  // Outputs aren't kept until the first Hessian
+  Eigen::MatrixXd X = RandomX();
+  constraint.set_iterate(1);
+  constraint.Evaluate(X, c);
+  constraint.Jacobian(X, J);
+  EvaluateHessian(constraint, X, 1.);
+  EXPECT(constraint.num_evaluations == 2);
+  EXPECT(constraint.num_jacobians == 2);
+
+  // Afterwards, the optimizer's evaluations at the same iterate are reused
+  X = RandomX();
+  constraint.set_iterate(2);
+  constraint.Evaluate(X, c);
+  constraint.Jacobian(X, J);
+  const Eigen::MatrixXd H = EvaluateHessian(constraint, X, 1.);
+  EXPECT(constraint.num_evaluations == 3);
+  EXPECT(constraint.num_jacobians == 3);
+  EXPECT_NEAR(H(4, 0), ResidualConstraint::Residual(X) > 0. ? 2. : -2., 1e-12);
+
+  // Missing outputs are evaluated at the current point
+  constraint.set_iterate(3);
+  constraint.Evaluate(X, c);
+  EvaluateHessian(constraint, X, 1.);
+  EXPECT(constraint.num_evaluations == 4);
+  EXPECT(constraint.num_jacobians == 4);
+
+  // Without iterates, nothing is reused
+  constraint.set_iterate(logic_opt::Constraint::kNoIterate);
+  constraint.Evaluate(X, c);
+  constraint.Jacobian(X, J);
+  EvaluateHessian(constraint, X, 1.);
+  EXPECT(constraint.num_evaluations == 6);
+  EXPECT(constraint.num_jacobians == 6);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  TestCentralDifferences();
+  TestForwardDifferences();
+  TestEntryRange();
+  TestIterates();
+  TestGaussNewtonHessian();
+  TestGaussNewtonCache();
+
+  return logic_opt::test::Result("constraint_test");
+}
@@ -0,0 +1,121 @@
+/**
+ * convex_decomposition_test.cc
+ *
+ * Copyright 2026. All Rights Reserved.
+ *
+ * Created: October 17, 2026
+ * Authors: Toki Migimatsu
+ */
+
+#include "logic_opt/convex_decomposition.h"
+
+#include <fstream>  // std::ofstream
+#include <string>   // std::string
+#include <vector>   // std::vector
+
+#include "test_utils.h"
+
+namespace {
+
+using logic_opt::ConvexDecomposition;
+using Point = ConvexDecomposition::Point;
+using Triangle = ConvexDecomposition::Triangle;
+
+/**
+ * Append the 12 triangles of the axis-aligned box [mins, maxs].
+ */
+void AddBox(const Point& mins, const Point& maxs, std::vector<Triangle>& triangles) {
+  const auto Corner = [&mins, &maxs](int i) -> Point {
+    return { (i & 1) ? maxs[0] : mins[0], (i & 2) ? maxs[1] : mins[1], (i & 4) ? maxs[2] : mins[2] };
+  };
+  const int faces[6][4] = {
+    { 0, 2, 3, 1 }, { 4, 5, 7, 6 },  // -z, +z
+    { 0, 1, 5, 4 }, { 2, 6, 7, 3 },  // -y, +y
+    { 0, 4, 6, 2 }, { 1, 3, 7, 5 }   // -x, +x
+  };
+  for (const auto& face : faces) {
+    triangles.push_back({ Corner(face[0]), Corner(face[1]), Corner(face[2]) });
+    triangles.push_back({ Corner(face[0]), Corner(face[2]), Corner(face[3]) });
+  }
+}
+
+std::vector<Triangle> Cube() {
+  std::vector<Triangle> triangles;
+  AddBox({ 0., 0., 0. }, { 1., 1., 1. }, triangles);
+  return triangles;
+}
+
+/**
+ * L-shaped union of two boxes, whose hull is far from the inner corner.
+ */
+std::vector<Triangle> LShape() {
+  std::vector<Triangle> triangles;
+  AddBox({ 0., 0., 0. }, { 2., 1., 1. }, triangles);
+  AddBox({ 0., 1., 0. }, { 1., 2., 1. }, triangles);
+  return triangles;
+}
+
+void WriteAsciiStl(const std::string& filename, const std::vector<Triangle>& triangles) {
+  std::ofstream file(filename);
+  file << "solid test" << std::endl;
+  for (const Triangle& triangle : triangles) {
+    file << "facet normal 0 0 0" << std::endl << "outer loop" << std::endl;
+    for (const Point& point : triangle) {
+      file << "vertex " << point[0] << " " << point[1] << " " << point[2] << std::endl;
+    }
+    file << "endloop" << std::endl << "endfacet" << std::endl;
+  }
+  file << "endsolid test" << std::endl;
+}
+
+void TestDecomposition() {
+  // Convex meshes aren't split
+  const ConvexDecomposition cube(Cube());
+  EXPECT(cube.hulls().size() == 1);
+  EXPECT(cube.hulls().size() == 1 && cube.hulls()[0].size() == 8);
+
+  // Concave meshes are split up to the part limit
+  const ConvexDecomposition l_shape(LShape(), 0.005, 16);
+  EXPECT(l_shape.hulls().size() > 1);
+  EXPECT(l_shape.hulls().size() <= 16);
+
+  const ConvexDecomposition l_shape_limited(LShape(), 0.005, 1);
+  EXPECT(l_shape_limited.hulls().size() == 1);
+}
+
+void TestCache() {
+  const std::string dir = logic_opt::test::CreateTempDirectory("convex_decomposition_test_");
+  const std::string filename_mesh = dir + "/mesh.stl";
+
+  WriteAsciiStl(filename_mesh, Cube());
+  auto decomposition = ConvexDecomposition::LoadOrCompute(filename_mesh);
+  EXPECT(decomposition != nullptr && decomposition->hulls().size() == 1);
+  EXPECT(logic_opt::test::ListDirectory(dir).size() == 2);
+
+  // Editing the mesh in place invalidates both the in-memory and file caches
+  WriteAsciiStl(filename_mesh, LShape());
+  decomposition = ConvexDecomposition::LoadOrCompute(filename_mesh);
+  EXPECT(decomposition != nullptr && decomposition->hulls().size() > 1);
+
+  WriteAsciiStl(filename_mesh, Cube());
+  decomposition = ConvexDecomposition::LoadOrCompute(filename_mesh);
+  EXPECT(decomposition != nullptr && decomposition->hulls().size() == 1);
+
+  // Decomposition parameters are part of the key
+  decomposition = ConvexDecomposition::LoadOrCompute(filename_mesh, 0.01, 4);
+  EXPECT(decomposition != nullptr && decomposition->hulls().size() == 1);
+
+  // Only STL files are supported
+  WriteAsciiStl(dir + "/mesh.obj", Cube());
+  EXPECT(ConvexDecomposition::LoadOrCompute(dir + "/mesh.obj") == nullptr);
+  EXPECT(ConvexDecomposition::LoadOrCompute(dir + "/missing.stl") == nullptr);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  TestDecomposition();
+  TestCache();
+
+  return logic_opt::test::Result("convex_decomposition_test");
+}
@@ -0,0 +1,128 @@
+/**
+ * grounding_test.cc
+ *
+ * Copyright 2026. All Rights Reserved.
+ *
+ * Created: October 17, 2026
+ * Authors: Toki Migimatsu
+ */
+
+#include "logic_opt/planning/breadth_first_search.h"
+#include "logic_opt/planning/grounding.h"
+#include "logic_opt/planning/pddl.h"
+#include "logic_opt/planning/planner.h"
+#include "logic_opt/planning/validator.h"
+
+#include <algorithm>  // std::any_of
+#include <set>        // std::set
+#include <string>     // std::string
+
+#include "test_utils.h"
+
+namespace {
+
+const std::string kDomain = LOGIC_OPT_TEST_RESOURCES_DIR "/grounding_domain.pddl";
+const std::string kProblem = LOGIC_OPT_TEST_RESOURCES_DIR "/grounding_problem.pddl";
+
+void TestNestedCondition() {
+  using logic_opt::GroundCondition;
+  using logic_opt::GroundConjunction;
+  using logic_opt::State;
+
+  // (0 or 1) and (2 or 3), kept nested
+  GroundCondition a;
+  a.terms = { GroundConjunction{ {0}, {} }, GroundConjunction{ {1}, {} } };
+  GroundCondition b;
+  b.terms = { GroundConjunction{ {2}, {} }, GroundConjunction{ {3}, {} } };
+  GroundCondition ab = a;
+  ab.conjuncts.push_back(b);
+
+  EXPECT(!ab.IsTrue());
+  EXPECT(!ab.IsFalse());
+
+  State state(4);
+  EXPECT(!ab.IsSatisfied(state));
+  state.Add(1);
+  EXPECT(!ab.IsSatisfied(state));
+  state.Add(3);
+  EXPECT(ab.IsSatisfied(state));
+  state.Remove(1);
+  EXPECT(!ab.IsSatisfied(state));
+
+  // ((0 or 1) and (2 or 3)) or 0
+  GroundCondition c;
+  c.terms = { GroundConjunction{ {0}, {} } };
+  c.disjuncts.push_back(ab);
+  EXPECT(!c.IsFalse());
+  state.Add(0);
+  state.Remove(3);
+  EXPECT(c.IsSatisfied(state));
+  state.Remove(0);
+  state.Add(1);
+  state.Add(2);
+  EXPECT(c.IsSatisfied(state));
+  state.Remove(2);
+  EXPECT(!c.IsSatisfied(state));
+}
+
+void TestEffects(const logic_opt::Validator& validator) {
+  // An atom that is both deleted and added stays true
+  const std::set<std::string> state_readd = validator.NextState({ "p(i1)" }, "readd(i1)");
+  EXPECT(state_readd.count("p(i1)") == 1);
+
+  // Conditional effects are evaluated in the state before the action
+  const std::set<std::string> state_consume = validator.NextState({ "q(i1)" }, "consume(i1)");
+  EXPECT(state_consume.count("q(i1)") == 0);
+  EXPECT(state_consume.count("r(i1)") == 1);
+}
+
+void TestOversizedPrecondition(const logic_opt::Validator& validator) {
+  // The precondition of finish expands to 2^13 terms, above kMaxTerms
+  std::set<std::string> state = validator.initial_state();
+  EXPECT(validator.IsValidAction(state, "finish(i1)"));
+  EXPECT(validator.NextState(state, "finish(i1)").count("done()") == 1);
+
+  state.erase("q(i13)");
+  EXPECT(!validator.IsValidAction(state, "finish(i1)"));
+
+  state.insert("p(i13)");
+  EXPECT(validator.IsValidAction(state, "finish(i1)"));
+
+  state.erase("p(i7)");
+  EXPECT(!validator.IsValidAction(state, "finish(i1)"));
+
+  state.insert("q(i7)");
+  EXPECT(validator.IsValidAction(state, "finish(i1)"));
+}
+
+void TestPlanner() {
+  const auto analysis = logic_opt::ParsePddl(kDomain, kProblem);
+  const logic_opt::Planner planner(analysis->the_domain, analysis->the_problem);
+
+  // The oversized precondition must not prune finish as unreachable
+  const std::vector<logic_opt::GroundAction>& actions = planner.actions();
+  EXPECT(std::any_of(actions.begin(), actions.end(), [](const logic_opt::GroundAction& action) {
+    return action.proposition().predicate() == "finish";
+  }));
+
+  size_t num_plans = 0;
+  logic_opt::BreadthFirstSearch<logic_opt::Planner::Node> bfs(planner.root(), 1);
+  for (const std::vector<logic_opt::Planner::Node>& plan : bfs) {
+    EXPECT(plan.back().action().predicate() == "finish");
+    num_plans++;
+  }
+  EXPECT(num_plans > 0);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  TestNestedCondition();
+
+  const logic_opt::Validator validator(kDomain, kProblem);
+  TestEffects(validator);
+  TestOversizedPrecondition(validator);
+  TestPlanner();
+
+  return logic_opt::test::Result("grounding_test");
+}
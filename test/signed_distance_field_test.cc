@@ -0,0 +1,99 @@
+/**
+ * signed_distance_field_test.cc
+ *
+ * Copyright 2026. All Rights Reserved.
+ *
+ * Created: October 17, 2026
+ * Authors: Toki Migimatsu
+ */
+
+#include "logic_opt/signed_distance_field.h"
+
+#include <string>  // std::string
+#include <vector>  // std::vector
+
+#include "test_utils.h"
+
+namespace {
+
+using logic_opt::SignedDistanceField;
+
+const double kResolution = 0.01;
+const double kMargin = 0.05;
+
+std::vector<spatial_dyn::Graphics> BallGraphics(double radius) {
+  spatial_dyn::Graphics graphics;
+  graphics.geometry.type = spatial_dyn::Graphics::Geometry::Type::kSphere;
+  graphics.geometry.radius = radius;
+  return { graphics };
+}
+
+void TestDistance(const SignedDistanceField& sdf, double radius) {
+  EXPECT_NEAR(sdf.Distance(Eigen::Vector3d(radius + 0.02, 0., 0.)), 0.02, kResolution);
+  EXPECT_NEAR(sdf.Distance(Eigen::Vector3d(0., 0., -radius / 2.)), -radius / 2., kResolution);
+
+  Eigen::Vector3d gradient;
+  sdf.Distance(Eigen::Vector3d(0., radius, 0.), &gradient);
+  EXPECT(gradient.normalized().isApprox(Eigen::Vector3d::UnitY(), 0.1));
+}
+
+void TestCache() {
+  const std::string cache_dir = logic_opt::test::CreateTempDirectory("sdf_test_");
+
+  // Computed fields are saved to the cache
+  const ncollide3d::shape::Ball ball(0.1);
+  const auto sdf = SignedDistanceField::LoadOrCompute(BallGraphics(0.1), ball, cache_dir,
+                                                      kResolution, kMargin);
+  EXPECT(sdf != nullptr);
+  if (sdf) TestDistance(*sdf, 0.1);
+  EXPECT(logic_opt::test::ListDirectory(cache_dir).size() == 1);
+
+  // The same geometry is loaded from the cache
+  const auto sdf_cached = SignedDistanceField::LoadOrCompute(BallGraphics(0.1), ball, cache_dir,
+                                                             kResolution, kMargin);
+  EXPECT(sdf_cached != nullptr);
+  if (sdf_cached) TestDistance(*sdf_cached, 0.1);
+  EXPECT(logic_opt::test::ListDirectory(cache_dir).size() == 1);
+
+  // Different geometry or grid parameters get new entries
+  const ncollide3d::shape::Ball ball_large(0.15);
+  const auto sdf_large = SignedDistanceField::LoadOrCompute(BallGraphics(0.15), ball_large,
+                                                            cache_dir, kResolution, kMargin);
+  EXPECT(sdf_large != nullptr);
+  if (sdf_large) TestDistance(*sdf_large, 0.15);
+  EXPECT(logic_opt::test::ListDirectory(cache_dir).size() == 2);
+
+  SignedDistanceField::LoadOrCompute(BallGraphics(0.1), ball, cache_dir, 2. * kResolution, kMargin);
+  EXPECT(logic_opt::test::ListDirectory(cache_dir).size() == 3);
+}
+
+void TestSaveLoad() {
+  const std::string cache_dir = logic_opt::test::CreateTempDirectory("sdf_test_");
+  const std::string filename = cache_dir + "/ball.sdf";
+  const SignedDistanceField sdf(ncollide3d::shape::Ball(0.1), kResolution, kMargin);
+
+  sdf.Save(filename, 42);
+  const auto sdf_loaded = SignedDistanceField::Load(filename, 42);
+  EXPECT(sdf_loaded != nullptr);
+  if (sdf_loaded) {
+    EXPECT(sdf_loaded->size().matrix() == sdf.size().matrix());
+    TestDistance(*sdf_loaded, 0.1);
+  }
+
+  // Keys must match, and missing files aren't errors
+  EXPECT(SignedDistanceField::Load(filename, 43) == nullptr);
+  EXPECT(SignedDistanceField::Load(cache_dir + "/missing.sdf", 42) == nullptr);
+
+  // Failing to save only warns and leaves no temporary files behind
+  EXPECT_NO_THROW(sdf.Save(cache_dir + "/missing/ball.sdf", 42));
+  EXPECT(logic_opt::test::ListDirectory(cache_dir).size() == 1);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  TestCache();
+  TestSaveLoad();
+
+  return logic_opt::test::Result("signed_distance_field_test");
+}
@@ -0,0 +1,96 @@
+/**
+ * test_utils.h
+ *
+ * Copyright 2026. All Rights Reserved.
+ *
+ * Created: October 17, 2026
+ * Authors: Toki Migimatsu
+ */
+
+#ifndef LOGIC_OPT_TEST_TEST_UTILS_H_
+#define LOGIC_OPT_TEST_TEST_UTILS_H_
+
+#include <cmath>      // std::abs
+#include <cstdlib>    // mkdtemp
+#include <iostream>   // std::cerr, std::endl
+#include <stdexcept>  // std::runtime_error
+#include <string>     // std::string
+#include <vector>     // std::vector
+
+#include <dirent.h>  // opendir, readdir, closedir
+
+namespace logic_opt {
+namespace test {
+
+inline size_t& NumFailures() {
+  static size_t num_failures = 0;
+  return num_failures;
+}
+
+inline void Expect(bool condition, const char* expression, const char* file, int line) {
+  if (condition) return;
+  std::cerr << file << ":" << line << ": Expected " << expression << std::endl;
+  ++NumFailures();
+}
+
+/**
+ * Exit code for main().
+ */
+inline int Result(const std::string& name_test) {
+  if (NumFailures() == 0) return 0;
+  std::cerr << name_test << ": " << NumFailures() << " failure(s)." << std::endl;
+  return 1;
+}
+
+/**
+ * Create an empty directory under /tmp for files written by a test.
+ */
+inline std::string CreateTempDirectory(const std::string& prefix) {
+  std::string path = "/tmp/" + prefix + "XXXXXX";
+  if (mkdtemp(&path[0]) == nullptr) {
+    throw std::runtime_error("CreateTempDirectory(): Failed to create " + path + ".");
+  }
+  return path;
+}
+
+/**
+ * Names of the files in the directory, excluding "." and "..".
+ */
+inline std::vector<std::string> ListDirectory(const std::string& path) {
+  std::vector<std::string> filenames;
+  DIR* dir = opendir(path.c_str());
+  if (dir == nullptr) return filenames;
+  for (dirent* entry = readdir(dir); entry != nullptr; entry = readdir(dir)) {
+    const std::string filename = entry->d_name;
+    if (filename == "." || filename == "..") continue;
+    filenames.push_back(filename);
+  }
+  closedir(dir);
+  return filenames;
+}
+
+}  // namespace test
+}  // namespace logic_opt
+
+#define EXPECT(condition) ::logic_opt::test::Expect((condition), #condition, __FILE__, __LINE__)
+
+#define EXPECT_NEAR(a, b, tol) \
+    ::logic_opt::test::Expect(std::abs((a) - (b)) <= (tol), #a " ~= " #b, __FILE__, __LINE__)
+
+#define EXPECT_THROW(statement, ExceptionT)                                   \
+    do {                                                                       \
+      bool is_thrown = false;                                                  \
+      try { statement; } catch (const ExceptionT&) { is_thrown = true; }       \
+      ::logic_opt::test::Expect(is_thrown, #statement " throws " #ExceptionT,  \
+                                __FILE__, __LINE__);                           \
+    } while (false)
+
+#define EXPECT_NO_THROW(statement)                                             \
+    do {                                                                       \
+      bool is_thrown = false;                                                  \
+      try { statement; } catch (...) { is_thrown = true; }                     \
+      ::logic_opt::test::Expect(!is_thrown, #statement " doesn't throw",       \
+                                __FILE__, __LINE__);                           \
+    } while (false)
+
+#endif  // LOGIC_OPT_TEST_TEST_UTILS_H_
@@ -0,0 +1,65 @@
+/**
+ * validator_test.cc
+ *
+ * Copyright 2026. All Rights Reserved.
+ *
+ * Created: October 17, 2026
+ * Authors: Toki Migimatsu
+ */
+
+#include "logic_opt/planning/validator.h"
+
+#include <set>        // std::set
+#include <stdexcept>  // std::invalid_argument
+#include <string>     // std::string
+
+#include "test_utils.h"
+
+namespace {
+
+void TestUnknownPropositions(const logic_opt::Validator& validator) {
+  // Propositions that aren't atoms of the problem are ignored
+  const std::set<std::string> state = { "p(i1)", "unknown(i1)", "p(ghost)", "=(i1, i1)" };
+
+  EXPECT_NO_THROW(validator.IsValidAction(state, "readd(i1)"));
+  EXPECT(validator.IsValidAction(state, "readd(i1)"));
+  EXPECT(!validator.IsValidAction(state, "readd(i2)"));
+
+  std::set<std::string> next_state;
+  EXPECT_NO_THROW(next_state = validator.NextState(state, "readd(i1)"));
+  EXPECT(next_state.count("p(i1)") == 1);
+  EXPECT(next_state.count("=(i1, i1)") == 1);
+  EXPECT(next_state.count("unknown(i1)") == 0);
+  EXPECT(next_state.count("p(ghost)") == 0);
+
+  EXPECT_NO_THROW(validator.IsGoalSatisfied({ "unknown(i1)" }));
+  EXPECT(!validator.IsGoalSatisfied({ "unknown(i1)", "p(ghost)" }));
+  EXPECT(validator.IsGoalSatisfied({ "done()", "unknown(i1)" }));
+}
+
+void TestInvalidActions(const logic_opt::Validator& validator) {
+  const std::set<std::string>& state = validator.initial_state();
+
+  EXPECT(!validator.IsValidAction(state, "fly(i1)"));
+  EXPECT(!validator.IsValidAction(state, "readd(i1, i2)"));
+  EXPECT_THROW(validator.NextState(state, "fly(i1)"), std::invalid_argument);
+}
+
+void TestPlan(const logic_opt::Validator& validator) {
+  EXPECT(!validator.IsValidPlan({ "consume(i13)", "readd(i1)" }));
+  EXPECT(validator.IsValidPlan({ "readd(i1)", "finish(i1)" }));
+  EXPECT(validator.IsValidTuple(validator.initial_state(), "finish(i2)",
+                                validator.NextState(validator.initial_state(), "finish(i2)")));
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  const logic_opt::Validator validator(LOGIC_OPT_TEST_RESOURCES_DIR "/grounding_domain.pddl",
+                                       LOGIC_OPT_TEST_RESOURCES_DIR "/grounding_problem.pddl");
+  TestUnknownPropositions(validator);
+  TestInvalidActions(validator);
+  TestPlan(validator);
+
+  return logic_opt::test::Result("validator_test");
+}
@@ -0,0 +1,140 @@
+/**
+ * world_test.cc
+ *
+ * Copyright 2026. All Rights Reserved.
+ *
+ * Created: October 17, 2026
+ * Authors: Toki Migimatsu
+ */
+
+#include "logic_opt/world.h"
+
+#include <map>        // std::map
+#include <memory>     // std::make_shared
+#include <stdexcept>  // std::invalid_argument
+#include <string>     // std::string
+
+#include <unsupported/Eigen/AutoDiff>
+
+#include "test_utils.h"
+
+namespace {
+
+using AutoDiff = Eigen::AutoDiffScalar<Eigen::VectorXd>;
+using logic_opt::World3;
+
+const size_t kNumTimesteps = 2;
+
+/**
+ * Frame a is controlled in the world at t = 0, b is controlled in a at
+ * t = 1, and c is fixed to b.
+ */
+World3 CreateWorld() {
+  auto objects = std::make_shared<std::map<std::string, logic_opt::Object3>>();
+  for (const std::string& name : { "a", "b", "c" }) {
+    spatial_dyn::RigidBody rb(name);
+    const Eigen::Quaterniond quat(Eigen::AngleAxisd(0.3, Eigen::Vector3d(1., 2., 3.).normalized()));
+    rb.set_T_to_parent(quat, Eigen::Vector3d(0.1, -0.2, 0.3));
+    objects->emplace(name, rb);
+  }
+
+  World3 world(objects, kNumTimesteps);
+  world.AttachFrame("a", World3::kWorldFrame, 0);
+  world.AttachFrame("b", "a", 1);
+  world.AttachFrame("c", "b", 0, true);
+  return world;
+}
+
+World3::MatrixT<AutoDiff> SeedDerivatives(const Eigen::MatrixXd& X) {
+  World3::MatrixT<AutoDiff> X_ad = X.cast<AutoDiff>();
+  for (int j = 0; j < X.cols(); j++) {
+    for (int i = 0; i < X.rows(); i++) {
+      X_ad(i, j) = AutoDiff(X(i, j), X.size(), X.rows() * j + i);
+    }
+  }
+  return X_ad;
+}
+
+void TestExpMapRotation() {
+  for (const double scale : { 1., 1e-3, 1e-6 }) {
+    const Eigen::Vector3d w = scale * Eigen::Vector3d::Random();
+    const Eigen::Matrix3d R = Eigen::AngleAxisd(w.norm(), w.normalized()).toRotationMatrix();
+    EXPECT(logic_opt::ExpMapRotation<double>(w).isApprox(R, 1e-12));
+  }
+
+  // d(R(w) p) / dw = -[p]x at w = 0
+  const Eigen::Vector3d p(1., 2., 3.);
+  Eigen::Matrix<AutoDiff, 3, 1> w_ad;
+  for (int i = 0; i < 3; i++) w_ad(i) = AutoDiff(0., 3, i);
+  const Eigen::Matrix<AutoDiff, 3, 1> Rp = logic_opt::ExpMapRotation<AutoDiff>(w_ad) *
+                                           p.cast<AutoDiff>();
+  Eigen::Matrix3d dRp_dw;
+  for (int i = 0; i < 3; i++) dRp_dw.row(i) = Rp(i).derivatives().transpose();
+
+  Eigen::Matrix3d p_cross;
+  p_cross << 0., -p(2), p(1),
+             p(2), 0., -p(0),
+             -p(1), p(0), 0.;
+  EXPECT(dRp_dw.isApprox(-p_cross, 1e-12));
+}
+
+void TestTransforms() {
+  const World3 world = CreateWorld();
+  const Eigen::MatrixXd X = Eigen::MatrixXd::Random(World3::kDof, kNumTimesteps);
+  const World3::MatrixT<AutoDiff> X_ad = SeedDerivatives(X);
+
+  // Scalar-generic transforms agree with the cached double ones
+  for (const std::string& frame : { "a", "b", "c" }) {
+    const auto T_ad = world.T_to_world(frame, X_ad, 1);
+    EXPECT(T_ad.matrix().unaryExpr([](const AutoDiff& x) { return x.value(); })
+               .isApprox(world.T_to_world(frame, X, 1).matrix(), 1e-12));
+  }
+
+  const Eigen::Matrix<AutoDiff, 3, 1> pos_ad = world.Position("c", "a", X_ad, 1);
+  const Eigen::Vector3d pos = world.Position("c", "a", X, 1);
+  for (int i = 0; i < 3; i++) EXPECT_NEAR(pos_ad(i).value(), pos(i), 1e-12);
+
+  const Eigen::Matrix<AutoDiff, 3, 3> ori_ad = world.Orientation("c", "a", X_ad, 1);
+  const Eigen::Matrix3d ori = world.Orientation("c", "a", X, 1);
+  for (int i = 0; i < 9; i++) EXPECT_NEAR(ori_ad(i).value(), ori(i), 1e-12);
+
+  const auto T_control_ad = world.T_control_to_target(X_ad, 1);
+  EXPECT(T_control_ad.matrix().unaryExpr([](const AutoDiff& x) { return x.value(); })
+             .isApprox(world.T_control_to_target(X, 1).matrix(), 1e-12));
+
+  EXPECT_THROW(world.Position("a", "c", X_ad, 1), std::invalid_argument);
+}
+
+void TestDerivatives() {
+  const World3 world = CreateWorld();
+  const Eigen::MatrixXd X = Eigen::MatrixXd::Random(World3::kDof, kNumTimesteps);
+  const World3::MatrixT<AutoDiff> X_ad = SeedDerivatives(X);
+
+  // Compare the derivatives of the position of c with central differences
+  const Eigen::Matrix<AutoDiff, 3, 1> pos_ad = world.Position("c", World3::kWorldFrame, X_ad, 1);
+  Eigen::Matrix3Xd J_ad(3, X.size());
+  for (int i = 0; i < 3; i++) J_ad.row(i) = pos_ad(i).derivatives().transpose();
+
+  const double h = 1e-6;
+  Eigen::Matrix3Xd J_fd(3, X.size());
+  Eigen::MatrixXd X_h = X;
+  for (int j = 0; j < X.size(); j++) {
+    X_h.data()[j] = X.data()[j] + h;
+    const Eigen::Vector3d pos_hp = world.Position("c", World3::kWorldFrame, X_h, 1);
+    X_h.data()[j] = X.data()[j] - h;
+    const Eigen::Vector3d pos_hn = world.Position("c", World3::kWorldFrame, X_h, 1);
+    X_h.data()[j] = X.data()[j];
+    J_fd.col(j) = (pos_hp - pos_hn) / (2. * h);
+  }
+  EXPECT((J_ad - J_fd).cwiseAbs().maxCoeff() < 1e-6);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  TestExpMapRotation();
+  TestTransforms();
+  TestDerivatives();
+
+  return logic_opt::test::Result("world_test");
+}